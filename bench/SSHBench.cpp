@@ -0,0 +1,113 @@
+#include "SSHManager.h"
+#include "CMLogger.h"
+
+/* std */
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <streambuf>
+
+constexpr const char* USAGE = R"(
+    Measures SSHManager against a device: session setup, command round trips and bulk reads.
+
+    Usage: cm-bench-ssh <ip> <port> <user> <password> [commands] [bulk_mb] [label]
+
+        commands            Number of `true` round trips to time (default 50)
+        bulk_mb             Size of the bulk read in MiB (default 16)
+        label               Name printed in front of the results (default "bench")
+    )";
+
+/* Discards everything written to it, counting the bytes. */
+class CountingBuffer : public std::streambuf {
+public:
+    size_t getCount() const { return count; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch != traits_type::eof()) ++count;
+        return ch;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        count += n;
+        return n;
+    }
+
+private:
+    size_t count{0};
+};
+
+static double toMs(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+}
+
+static double percentile(std::vector<double>& samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+    return samples[index];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << USAGE << std::endl;
+        return 1;
+    }
+
+    CredentialsSSH credentials{argv[3], argv[4], argv[1], std::stoi(argv[2])};
+    int commands = argc > 5 ? std::stoi(argv[5]) : 50;
+    size_t bulkBytes = (argc > 6 ? std::stoul(argv[6]) : 16) << 20;
+    std::string label = argc > 7 ? argv[7] : "bench";
+
+    try {
+        utils::CMLogger::setFilepath("/dev/null");
+
+        SSHOptions options;
+        options.sessionDeadline = std::chrono::milliseconds(60000);
+        SSHManager sm{credentials, options};
+
+        sm.openSession();
+        const SessionTimings& timings = sm.getTimings();
+
+        std::vector<double> roundTrips;
+        for (int i = 0; i < commands; ++i) {
+            CountingBuffer sink;
+            std::ostream out(&sink);
+
+            auto started = std::chrono::steady_clock::now();
+            sm.execute("true", out);
+            roundTrips.push_back(toMs(std::chrono::steady_clock::now() - started));
+        }
+
+        CountingBuffer sink;
+        std::ostream out(&sink);
+        auto started = std::chrono::steady_clock::now();
+        sm.execute("head -c " + std::to_string(bulkBytes) + " /dev/zero", out);
+        double bulkSeconds = toMs(std::chrono::steady_clock::now() - started) / 1000;
+
+        sm.closeSession();
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << label << ": connect " << toMs(timings.connect) << " ms"
+                  << ", handshake " << toMs(timings.handshake) << " ms"
+                  << ", auth " << toMs(timings.auth) << " ms" << std::endl;
+        if (!roundTrips.empty()) {
+            std::cout << label << ": command rtt p50 " << percentile(roundTrips, 0.50) << " ms"
+                      << ", p90 " << percentile(roundTrips, 0.90) << " ms"
+                      << ", p99 " << percentile(roundTrips, 0.99) << " ms"
+                      << ", max " << roundTrips.back() << " ms (" << commands << " runs)" << std::endl;
+        }
+        std::cout << std::setprecision(2)
+                  << label << ": bulk read " << sink.getCount() / 1048576.0 << " MiB in " << bulkSeconds << " s"
+                  << ", " << sink.getCount() / 1048576.0 / bulkSeconds << " MiB/s" << std::endl;
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << label << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#!/bin/bash
+#
+# Runs cm-bench-ssh against a throwaway sshd living in a network namespace,
+# once per emulated link profile. Everything created here is removed on exit.
+#
+# Usage: ssh-bench.sh <cm-bench-ssh binary>
+#   PROFILES    link profiles to run (default "none lte sat")
+#   COMMANDS    command round trips per profile (default 50)
+#   BULK_MB     bulk read size per profile in MiB (default 16)
+
+if [[ $EUID -ne 0 ]]; then
+    exec sudo PROFILES="$PROFILES" COMMANDS="$COMMANDS" BULK_MB="$BULK_MB" "$0" "$@"
+fi
+
+BENCH=$(realpath "${1:-./cm-bench-ssh}")
+PROFILES=${PROFILES:-"none lte sat"}
+COMMANDS=${COMMANDS:-50}
+BULK_MB=${BULK_MB:-16}
+
+NETNS="cmbench"
+VETH_HOST="cmb0"
+VETH_PEER="cmb1"
+IP_HOST="10.77.0.1"
+IP_PEER="10.77.0.2"
+PORT=2222
+BENCH_USER="cmbench"
+BENCH_PASSWORD="cmbench-$RANDOM$RANDOM"
+WORKDIR=$(mktemp -d)
+
+# Set once setup has created the resource, cleanup leaves everything else alone.
+CREATED_NETNS=0
+CREATED_VETH=0
+CREATED_USER=0
+CREATED_RUNDIR=0
+
+cleanup() {
+    [[ -f $WORKDIR/sshd.pid ]] && kill "$(cat "$WORKDIR/sshd.pid")" 2>/dev/null
+    [[ $CREATED_VETH -eq 1 ]] && ip link delete $VETH_HOST 2>/dev/null
+    [[ $CREATED_NETNS -eq 1 ]] && ip netns delete $NETNS 2>/dev/null
+    [[ $CREATED_USER -eq 1 ]] && userdel -r $BENCH_USER &>/dev/null
+    [[ $CREATED_RUNDIR -eq 1 ]] && rmdir /run/sshd 2>/dev/null
+    rm -rf "$WORKDIR"
+}
+
+fail() {
+    echo "ssh-bench: $1" >&2
+    exit 1
+}
+
+# Applies half of the profile's round trip delay on each side of the pair.
+shape() {
+    local delay loss rate
+    case $1 in
+        none) delay=0;   loss=0;   rate="" ;;
+        lte)  delay=30;  loss=0.1; rate="20mbit" ;;
+        sat)  delay=300; loss=0.5; rate="2mbit" ;;
+        *)    fail "unknown profile $1" ;;
+    esac
+
+    tc qdisc del dev $VETH_HOST root 2>/dev/null
+    ip netns exec $NETNS tc qdisc del dev $VETH_PEER root 2>/dev/null
+    [[ $1 == none ]] && return
+
+    tc qdisc add dev $VETH_HOST root netem delay ${delay}ms loss ${loss}% rate $rate &&
+        ip netns exec $NETNS tc qdisc add dev $VETH_PEER root netem delay ${delay}ms loss ${loss}% rate $rate ||
+        fail "cannot shape the link for profile $1, is sch_netem available?"
+}
+
+setup() {
+    local sshd
+    sshd=$(command -v sshd || echo /usr/sbin/sshd)
+    [[ -x $BENCH ]] || fail "benchmark binary $BENCH not found"
+    [[ -x $sshd ]] || fail "sshd is not installed"
+    command -v tc &>/dev/null || fail "tc is not installed"
+    ip netns list | grep -qw $NETNS && fail "network namespace $NETNS already exists"
+    ip link show $VETH_HOST &>/dev/null && fail "interface $VETH_HOST already exists"
+    id $BENCH_USER &>/dev/null && fail "user $BENCH_USER already exists"
+
+    ip netns add $NETNS || fail "cannot create network namespace $NETNS"
+    CREATED_NETNS=1
+    ip link add $VETH_HOST type veth peer name $VETH_PEER || fail "cannot create veth pair $VETH_HOST"
+    CREATED_VETH=1
+    ip link set $VETH_PEER netns $NETNS
+    ip addr add $IP_HOST/24 dev $VETH_HOST
+    ip link set $VETH_HOST up
+    ip netns exec $NETNS ip addr add $IP_PEER/24 dev $VETH_PEER
+    ip netns exec $NETNS ip link set $VETH_PEER up
+    ip netns exec $NETNS ip link set lo up
+
+    useradd -m $BENCH_USER || fail "cannot create user $BENCH_USER"
+    CREATED_USER=1
+    echo "$BENCH_USER:$BENCH_PASSWORD" | chpasswd
+
+    if [[ ! -d /run/sshd ]]; then
+        mkdir /run/sshd || fail "cannot create /run/sshd"
+        CREATED_RUNDIR=1
+    fi
+    ssh-keygen -q -t ed25519 -N "" -f "$WORKDIR/host_key"
+    cat > "$WORKDIR/sshd_config" <<CONFIG
+Port $PORT
+ListenAddress $IP_PEER
+HostKey $WORKDIR/host_key
+PidFile $WORKDIR/sshd.pid
+PasswordAuthentication yes
+KbdInteractiveAuthentication no
+UsePAM no
+AllowUsers $BENCH_USER
+CONFIG
+
+    ip netns exec $NETNS "$sshd" -f "$WORKDIR/sshd_config" || fail "sshd did not start"
+    for _ in $(seq 50); do
+        [[ -f $WORKDIR/sshd.pid ]] && return
+        sleep 0.1
+    done
+    fail "sshd did not write its pid file"
+}
+
+trap cleanup EXIT
+setup
+
+for profile in $PROFILES; do
+    shape "$profile"
+    "$BENCH" $IP_PEER $PORT $BENCH_USER "$BENCH_PASSWORD" "$COMMANDS" "$BULK_MB" "$profile"
+done
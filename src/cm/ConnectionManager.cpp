@@ -1,28 +1,61 @@
 #include "ConnectionManager.h"
+#include "SimulatedLinkBackend.h"
 #include "CMLogger.h"
 
 /* std */
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <cstring>
-#include <unistd.h>
-#include <arpa/inet.h>
-#include <netinet/in.h>
-#include <sys/ioctl.h>
-#include <net/if.h>
 
-constexpr int TIMEOUT = 5;
+/* One extra subflow per monitored interface. */
+constexpr uint32_t MPTCP_MAX_SUBFLOWS = 2;
 
 ConnectionManager::ConnectionManager(utils::Config config) 
-    : if0{config.ifname0}, if1{config.ifname1}, isUsingSSH{config.isUsingSSH}, sm{config.credentials}
+    : if0{config.ifname0}, if1{config.ifname1}, isUsingSSH{config.isUsingSSH}, 
+      probeInterval{config.probeIntervalMs}, retryInterval{config.retryIntervalMs}, holdDown{config.holdDownMs},
+      clock{!config.simTracePath.empty(), config.simSpeed}, status{config.statusPage}, timers{clock}, sm{config.credentials, config.sshOptions}
 {
     utils::CMLogger::log(utils::INFO, "Initializing CM...");
-    monitorThread.start(if0, if1);
+    status.setInterface(0, if0.ifname);
+    status.setInterface(1, if1.ifname);
+    if (config.simTracePath.empty()) {
+        backend.reset(new SystemLinkBackend());
+    }
+    else {
+        backend.reset(new SimulatedLinkBackend(config.simTracePath, clock, config.simSeed));
+    }
+    sm.onLiveness = [this](bool alive, std::chrono::microseconds rtt) {
+        status.setProbeResult(interfaceIndex(activeInterface), alive, rtt);
+    };
+    if (isUsingSSH && config.sshOptions.useMptcp) {
+        pathManager.reset(new MptcpPathManager(MPTCP_MAX_SUBFLOWS));
+    }
+    if (isUsingSSH && config.useRouting) {
+        router.reset(new PolicyRouter(config.credentials.ip, 
+            {{if0.ifname, config.gateway0}, {if1.ifname, config.gateway1}}, config.routeTable));
+    }
+    if (isUsingSSH && config.warmIntervalMs > 0) {
+        uint32_t fwmark0 = router ? config.routeTable + 1 : 0;
+        uint32_t fwmark1 = router ? config.routeTable + 2 : 0;
+        warmer.reset(new PathWarmer(config.credentials.ip, 
+            {{if0.ifname, config.gateway0, fwmark0}, {if1.ifname, config.gateway1, fwmark1}}, 
+            std::chrono::milliseconds(config.warmIntervalMs), timers));
+    }
+    monitorThread.onLinkChange = [this](int index, const interface& iface) {
+        handleLinkChange(index, iface);
+    };
+    timers.start();
+    monitorThread.start(if0, if1, *backend, timers, 
+                        std::chrono::milliseconds(config.monitorIntervalMs), linkChanged, status);
+}
+
+ConnectionManager::~ConnectionManager() {
+    timers.stop();
 }
 
 std::string ConnectionManager::selectAvailableInterface() {
-    if (if0.status) {
+    bool if0Held = (heldInterface == if0.ifname && clock.now() < heldUntil);
+
+    if (if0.status && !(if0Held && if1.status)) {
         utils::CMLogger::log(utils::INFO, if0.ifname + " had been chosen to connect to.");
         return if0.ifname;
     } else if (if1.status) {
@@ -33,62 +66,80 @@ std::string ConnectionManager::selectAvailableInterface() {
     return "";
 }
 
-std::string ConnectionManager::resolveIPbyIF(const std::string& ifname) {
-    struct ifreq ifr;
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    
-    if (sockfd == -1) {
-        std::cerr << "Socket creation failed: " << strerror(errno) << std::endl;
-        return "";
+void ConnectionManager::activateInterface(const std::string& ifname) {
+    if (!ifname.empty() && ifname != activeInterface) {
+        if (!activeInterface.empty()) {
+            ++failoverCount;
+            utils::CMLogger::log(utils::INFO, "Failover from " + activeInterface + " to " + ifname + 
+                " (" + std::to_string(failoverCount) + " so far)");
+        }
+        activeInterface = ifname;
+        if (router) {
+            router->switchTo(interfaceIndex(ifname));
+        }
+        if (warmer) {
+            warmer->setActive(interfaceIndex(ifname));
+        }
     }
 
-    std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ);
-    if (ioctl(sockfd, SIOCGIFADDR,& ifr) == -1) {
-        std::cerr << "Error getting IP address for interface " << ifname << ": " << strerror(errno) << std::endl;
-        close(sockfd);
-        return "";
-    }
+    status.setActiveInterface(interfaceIndex(ifname), failoverCount);
+}
 
-    sockaddr_in *ipaddr = (sockaddr_in*)&ifr.ifr_addr;
-    char ip_str[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET,& ipaddr->sin_addr, ip_str, INET_ADDRSTRLEN);
+void ConnectionManager::handleLinkChange(int index, const interface& iface) {
+    bool up = iface.status.load();
 
-    close(sockfd);
+    if (pathManager) {
+        pathManager->update(index, iface.ifname, up ? backend->resolveAddress(iface.ifname) : "", up);
+    }
+    if (router) {
+        router->update(index, up);
+    }
+    if (warmer) {
+        warmer->update(index, up);
+    }
+}
 
-    return std::string(ip_str);
+int ConnectionManager::interfaceIndex(const std::string& ifname) const {
+    if (ifname == if0.ifname) return 0;
+    if (ifname == if1.ifname) return 1;
+    return -1;
 }
 
-void ConnectionManager::connectToDeviceMock(std::string& interfaceIpAddr) {
+void ConnectionManager::connectToDeviceMock(const std::string& ifname, const std::string& interfaceIpAddr) {
     bool isConnected = true;
 
-    while (isConnected) {
-        std::string command = "ping -c 1 " + interfaceIpAddr;
-
-        int result = std::system(command.c_str());
+    while (isConnected && !backend->finished()) {
+        ProbeResult result = backend->probe(ifname, interfaceIpAddr);
+        status.setProbeResult(interfaceIndex(ifname), result.reachable, result.rtt);
 
-        if (result != 0) {
+        if (!result.reachable) {
             isConnected = false;
             std::cout << "Connection lost to " << interfaceIpAddr << std::endl;
         } else {
-            monitorThread.isConnectionEstablished.store(true);
-            std::cout << "Ping successful to " << interfaceIpAddr << std::endl;
+            monitorThread.setConnectionEstablished(true);
+            std::cout << "Ping successful to " << interfaceIpAddr << 
+                " (" << result.rtt.count() / 1000.0 << " ms)" << std::endl;
         }
 
-        std::this_thread::sleep_for(std::chrono::seconds(TIMEOUT));
+        bool elapsed = timers.sleepFor(probeInterval, linkChanged);
+        if (!elapsed && !(ifname == if0.ifname ? if0 : if1).status.load()) {
+            isConnected = false;
+            std::cout << "Link lost on " << ifname << std::endl;
+        }
     }
 }
 
 bool ConnectionManager::connection_check(const std::string& interface, const std::string& ip) {
-    std::string command = "ping -I " + interface + " -c 1 " + ip + " > /dev/null 2>&1";
-
-    int result = std::system(command.c_str());
+    ProbeResult result = backend->probe(interface, ip);
+    status.setProbeResult(interfaceIndex(interface), result.reachable, result.rtt);
 
-    return result == 0;
+    return result.reachable;
 }
 
 void ConnectionManager::run() {
-    while (true) {
+    while (!backend->finished()) {
         std::string selectedInterface = selectAvailableInterface();
+        activateInterface(selectedInterface);
         try {
             if (!selectedInterface.empty()) {
                 utils::CMLogger::log(utils::INFO, "Interface found, connecting to device...");
@@ -104,21 +155,31 @@ void ConnectionManager::run() {
                 }
                 else {
                     utils::CMLogger::log(utils::INFO, "Establishing connectio via Mock");
-                    std::string ip = resolveIPbyIF(selectedInterface);
-                    connectToDeviceMock(ip);
+                    std::string ip = backend->resolveAddress(selectedInterface);
+                    connectToDeviceMock(selectedInterface, ip);
                 }
 
-                monitorThread.isConnectionEstablished.store(false);
+                monitorThread.setConnectionEstablished(false);
                 utils::CMLogger::log(utils::INFO, "Connection session ended");
             }
             else {
                 utils::CMLogger::log(utils::INFO, "No interfaces are unavailable. Retrying...");
             }
-            std::this_thread::sleep_for(std::chrono::seconds(TIMEOUT));
+            timers.sleepFor(retryInterval, linkChanged);
+        }
+        catch (const SessionDeadError& e) {
+            utils::CMLogger::log(utils::ERROR, std::string(e.what()));
+            monitorThread.setConnectionEstablished(false);
+            heldInterface = selectedInterface;
+            heldUntil = clock.now() + holdDown;
+            utils::CMLogger::log(utils::INFO, selectedInterface + " held down for " + 
+                std::to_string(holdDown.count()) + " ms");
         }
         catch (const std::runtime_error& e) {
             utils::CMLogger::log(utils::ERROR, std::string(e.what()));
-            std::this_thread::sleep_for(std::chrono::seconds(TIMEOUT / 2));
+            timers.sleepFor(retryInterval / 2, linkChanged);
         }
     }
+
+    utils::CMLogger::log(utils::INFO, "Link simulation finished at " + std::to_string(clock.now().count()) + " ms");
 }
\ No newline at end of file
@@ -2,6 +2,15 @@
 
 #include "MonitorThread.h"
 #include "SSHManager.h"
+#include "LinkBackend.h"
+#include "Clock.h"
+#include "TimerService.h"
+#include "StatusPublisher.h"
+#include "MptcpPathManager.h"
+#include "PolicyRouter.h"
+#include "PathWarmer.h"
+
+#include <memory>
 
 class ConnectionManager {
 public:
@@ -10,11 +19,17 @@ public:
 
     ConnectionManager(utils::Config config);
 
+    /** 
+     * @brief Stops the timer service first, so no callback runs while members are torn down.
+     */
+    ~ConnectionManager();
+
     /** 
      * @brief Runs the main logic of the CM.
      * 
      * This method is responsible for starting the connection process, managing interfaces,
-     * and ensuring the connection state is handled properly.
+     * and ensuring the connection state is handled properly. Returns once the link backend
+     * reports it is finished, which only happens when replaying a simulated trace.
      */
     void run();
 
@@ -26,22 +41,35 @@ private:
      * @brief Selects the available network interface.
      * 
      * This method selects an available network interface by evaluating the status of the
-     * monitored interfaces and determining which one is online.
+     * monitored interfaces and determining which one is online. An interface whose session was
+     * declared dead is skipped during its hold-down while the other interface is online.
      * 
      * @return std::string The name of the available interface (e.g., "eth0", "wlp0s20f3").
      */
     std::string selectAvailableInterface();
 
     /** 
-     * @brief Resolves the IP address associated with a given network interface.
+     * @brief Makes `ifname` the interface CM uses, counting a failover if it replaces another one.
      * 
-     * This method resolves and returns the IP address for the specified network interface.
+     * @param ifname The selected interface, empty when none is available.
+     */
+    void activateInterface(const std::string& ifname);
+
+    /** 
+     * @brief Reacts to a change of an interface's link state reported by `MonitorThread`.
      * 
-     * @param interface The name of the network interface (e.g., "eth0", "wlp0s20f3").
+     * Runs on the timer thread and keeps the MPTCP endpoints, device routes and warmed
+     * standby paths in step.
      * 
-     * @return std::string The IP address of the interface.
+     * @param index Index of the interface.
+     * @param iface The interface whose state changed.
+     */
+    void handleLinkChange(int index, const interface& iface);
+
+    /** 
+     * @return int 0 for `if0`, 1 for `if1`, -1 for anything else.
      */
-    std::string resolveIPbyIF(const std::string& interface);
+    int interfaceIndex(const std::string& ifname) const;
 
     bool connection_check(const std::string& interface, const std::string& ip);
 
@@ -51,14 +79,30 @@ private:
      * This method simulates the connection to a device by using a mock interface IP address.
      * The connection process is simulated by repeatedly pinging the device until a failure occurs.
      * 
+     * @param ifname The interface the probes are sent through.
      * @param interfaceIpAddr The IP address of the interface to be used for the mock connection.
      */
-    void connectToDeviceMock(std::string& interfaceIpAddr);
+    void connectToDeviceMock(const std::string& ifname, const std::string& interfaceIpAddr);
 
     /* members */
     interface if0;
     interface if1;
     bool isUsingSSH;
+    std::chrono::milliseconds probeInterval;
+    std::chrono::milliseconds retryInterval;
+    std::chrono::milliseconds holdDown;
+    std::string heldInterface;
+    std::chrono::milliseconds heldUntil{0};
+    std::string activeInterface;
+    uint32_t failoverCount{0};
+    utils::Clock clock;
+    StatusPublisher status;
+    std::unique_ptr<LinkBackend> backend;
+    std::unique_ptr<MptcpPathManager> pathManager;
+    std::unique_ptr<PolicyRouter> router;
+    utils::TimerService timers;
+    std::unique_ptr<PathWarmer> warmer;
+    utils::Wakeup linkChanged;
     SSHManager sm;
     MonitorThread monitorThread;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "LinkBackend.h"
+#include "CMLogger.h"
+
+/* std */
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+
+bool SystemLinkBackend::isLinkUp(const std::string& ifname) {
+    ifreq ifr{};
+    bool res{ false };
+
+    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sockfd == -1) {
+        utils::CMLogger::log(utils::INFO, "Socket creation failed: " + std::string(strerror(errno)));
+        return res;
+    }
+
+    std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ);
+
+    res = (ioctl(sockfd, SIOCGIFFLAGS,& ifr) != -1);
+
+    close(sockfd);
+    return res;
+}
+
+ProbeResult SystemLinkBackend::probe(const std::string& ifname, const std::string& ip) {
+    ProbeResult result{false, std::chrono::microseconds(0)};
+    std::string command = "ping -I " + ifname + " -c 1 " + ip + " 2>/dev/null";
+
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        utils::CMLogger::log(utils::ERROR, "Failed to run ping: " + std::string(strerror(errno)));
+        return result;
+    }
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), pipe)) {
+        const char *time = std::strstr(line, "time=");
+        if (time) {
+            result.rtt = std::chrono::microseconds(static_cast<long long>(std::atof(time + 5) * 1000));
+        }
+    }
+
+    result.reachable = (pclose(pipe) == 0);
+    return result;
+}
+
+std::string SystemLinkBackend::resolveAddress(const std::string& ifname) {
+    struct ifreq ifr;
+    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    
+    if (sockfd == -1) {
+        utils::CMLogger::log(utils::ERROR, "Socket creation failed: " + std::string(strerror(errno)));
+        return "";
+    }
+
+    std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ);
+    if (ioctl(sockfd, SIOCGIFADDR,& ifr) == -1) {
+        utils::CMLogger::log(utils::ERROR, "Error getting IP address for interface " + ifname + ": " + strerror(errno));
+        close(sockfd);
+        return "";
+    }
+
+    sockaddr_in *ipaddr = (sockaddr_in*)&ifr.ifr_addr;
+    char ip_str[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET,& ipaddr->sin_addr, ip_str, INET_ADDRSTRLEN);
+
+    close(sockfd);
+
+    return std::string(ip_str);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+
+struct ProbeResult {
+    bool reachable;
+    std::chrono::microseconds rtt;
+};
+
+/**
+ * Source of link state and reachability used by `MonitorThread` and the probe path.
+ * The system backend talks to the real interfaces, the simulated one replays a trace.
+ */
+class LinkBackend {
+public:
+
+    virtual ~LinkBackend() = default;
+
+    /* methods */
+
+    /** 
+     * @brief Checks if the network is available on the given interface.
+     * 
+     * @param ifname The name of the interface.
+     * 
+     * @return bool `true` if the network is available, `false` otherwise.
+     */
+    virtual bool isLinkUp(const std::string& ifname) = 0;
+
+    /** 
+     * @brief Sends a single reachability probe to `ip` through `ifname`.
+     * 
+     * @param ifname The name of the interface to probe through.
+     * @param ip The address to probe.
+     * 
+     * @return ProbeResult Whether the probe was answered and its round-trip time.
+     */
+    virtual ProbeResult probe(const std::string& ifname, const std::string& ip) = 0;
+
+    /** 
+     * @brief Resolves the IP address associated with a given network interface.
+     * 
+     * @param ifname The name of the network interface (e.g., "eth0", "wlp0s20f3").
+     * 
+     * @return std::string The IP address of the interface, empty on failure.
+     */
+    virtual std::string resolveAddress(const std::string& ifname) = 0;
+
+    /** 
+     * @brief Tells whether the backend has nothing more to report.
+     * 
+     * @return bool `true` once a replayed trace is exhausted, always `false` for real links.
+     */
+    virtual bool finished() { return false; }
+};
+
+class SystemLinkBackend : public LinkBackend {
+public:
+
+    /* methods */
+
+    bool isLinkUp(const std::string& ifname) override;
+
+    /** 
+     * @brief Pings `ip` once through `ifname` and parses the reported round-trip time.
+     */
+    ProbeResult probe(const std::string& ifname, const std::string& ip) override;
+
+    std::string resolveAddress(const std::string& ifname) override;
+};
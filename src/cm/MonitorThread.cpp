@@ -3,65 +3,70 @@
 
 /* std */
 #include <string>
-#include <cstring>
-#include <unistd.h>
-#include <netinet/in.h>
-#include <sys/ioctl.h>
-#include <net/if.h>
 
-constexpr int TIMEOUT = 5;
+void MonitorThread::start(interface& if0, interface& if1, LinkBackend& backend, utils::TimerService& timers,
+                          std::chrono::milliseconds period, utils::Wakeup& linkChanged, StatusPublisher& status) {
+    utils::CMLogger::log(utils::INFO, "Starting interface monitor...");
+    this->backend = &backend;
+    this->timers = &timers;
+    this->linkChanged = &linkChanged;
+    this->status = &status;
 
-void MonitorThread::start(interface& if0, interface& if1) {
-    utils::CMLogger::log(utils::INFO, "Starting interface monitor thread...");
-    thread = std::thread(&MonitorThread::monitorNetworkStatus, this, std::ref(if0), std::ref(if1));
-    thread.detach();
+    monitorNetworkStatus(if0, if1);
+    timer = timers.schedulePeriodic(period, [this, &if0, &if1] {
+        monitorNetworkStatus(if0, if1);
+    });
 }
 
-void MonitorThread::monitorNetworkStatus(interface& if0, interface& if1) {
-    while (true) {
-        if0.status.store(isNetworkAvailable(if0.ifname));
-        if1.status.store(isNetworkAvailable(if1.ifname));
-
-        if (if0.status) {
-            utils::CMLogger::log(utils::INFO, if0.ifname + " is online.");
-        }
-        else {
-            utils::CMLogger::log(utils::INFO, if0.ifname + " is offline.");
-        }
-
-        if (if1.status) {
-            utils::CMLogger::log(utils::INFO, if1.ifname + " is online.");
-        }
-        else {
-            utils::CMLogger::log(utils::INFO, if1.ifname + " is offline.");
-        }
-
-        if (isConnectionEstablished.load()) {
-            utils::CMLogger::log(utils::INFO, "Connection to device established");
-        }
-        else {
-            utils::CMLogger::log(utils::INFO, "Connection to device is not established");
-        }
-
-        std::this_thread::sleep_for(std::chrono::seconds(TIMEOUT));
+void MonitorThread::stop() {
+    if (timers && timer) {
+        timers->cancel(timer);
+        timer = 0;
     }
 }
 
-bool MonitorThread::isNetworkAvailable(const std::string& ifname) {
-    ifreq ifr{};
-    bool res{ false };
+void MonitorThread::monitorNetworkStatus(interface& if0, interface& if1) {
+    bool if0Up = backend->isLinkUp(if0.ifname);
+    bool if1Up = backend->isLinkUp(if1.ifname);
+    bool if0Changed = (if0.status.exchange(if0Up) != if0Up);
+    bool if1Changed = (if1.status.exchange(if1Up) != if1Up);
+    status->setLinkUp(0, if0Up);
+    status->setLinkUp(1, if1Up);
+
+    if (onLinkChange) {
+        if (if0Changed) onLinkChange(0, if0);
+        if (if1Changed) onLinkChange(1, if1);
+    }
 
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sockfd == -1) {
-        utils::CMLogger::log(utils::INFO, "Socket creation failed: " + std::string(strerror(errno)));
-        return res;
+    if (if0Changed || if1Changed) {
+        linkChanged->notify();
     }
 
-    std::strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ);
+    if (if0.status) {
+        utils::CMLogger::log(utils::INFO, if0.ifname + " is online.");
+    }
+    else {
+        utils::CMLogger::log(utils::INFO, if0.ifname + " is offline.");
+    }
 
-    res = (ioctl(sockfd, SIOCGIFFLAGS,& ifr) != -1);
+    if (if1.status) {
+        utils::CMLogger::log(utils::INFO, if1.ifname + " is online.");
+    }
+    else {
+        utils::CMLogger::log(utils::INFO, if1.ifname + " is offline.");
+    }
 
-    close(sockfd);
-    return res;
+    if (isConnectionEstablished.load()) {
+        utils::CMLogger::log(utils::INFO, "Connection to device established");
+    }
+    else {
+        utils::CMLogger::log(utils::INFO, "Connection to device is not established");
+    }
 }
 
+void MonitorThread::setConnectionEstablished(bool established) {
+    isConnectionEstablished.store(established);
+    if (status) {
+        status->setConnectionEstablished(established);
+    }
+}
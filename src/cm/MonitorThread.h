@@ -1,8 +1,12 @@
 #pragma once
 
-#include <thread>
 #include <string>
 #include <atomic>
+#include <functional>
+
+#include "LinkBackend.h"
+#include "TimerService.h"
+#include "StatusPublisher.h"
 
 struct interface {
     std::string ifname;
@@ -16,19 +20,32 @@ struct MonitorThread {
         /** 
          * @brief Starts the monitoring of network interfaces.
          * 
-         * This method initiates the monitoring of two network interfaces (`if0` and `if1`) by creating 
-         * a separate thread that continuously checks the network status of both interfaces.
+         * This method checks both network interfaces (`if0` and `if1`) once and then schedules a
+         * periodic check on the timer service, so no thread of its own is needed.
          * 
          * @param if0 The first network interface to be monitored.
          * @param if1 The second network interface to be monitored.
+         * @param backend The source of link state for both interfaces.
+         * @param timers The timer service running the periodic check.
+         * @param period Interval between two checks.
+         * @param linkChanged Notified whenever the status of either interface changes.
+         * @param status Status page the interface states are published to.
          */
-        void start(interface& if0, interface& if1);
+        void start(interface& if0, interface& if1, LinkBackend& backend, utils::TimerService& timers,
+                   std::chrono::milliseconds period, utils::Wakeup& linkChanged, StatusPublisher& status);
 
         /** 
-         * @brief Monitors the network status of the given interfaces.
+         * @brief Cancels the periodic check scheduled by `start`.
+         */
+        void stop();
+
+        ~MonitorThread() { stop(); }
+
+        /** 
+         * @brief Checks the network status of the given interfaces once.
          * 
-         * This method runs in a separate thread and continuously checks the availability of both 
-         * network interfaces (`if0` and `if1`), updating the connection status accordingly.
+         * This method runs on the timer service thread, checks the availability of both 
+         * network interfaces (`if0` and `if1`) and updates the connection status accordingly.
          * 
          * @param if0 The first network interface to be monitored.
          * @param if1 The second network interface to be monitored.
@@ -36,18 +53,18 @@ struct MonitorThread {
         void monitorNetworkStatus(interface& if0, interface& if1);
 
         /** 
-         * @brief Checks if the network is available on the given interface.
-         * 
-         * This method checks the network status of the specified interface to determine if the network
-         * is accessible and operational.
-         * 
-         * @param ifname The name of the interface.
+         * @brief Stores and publishes whether a connection to the device is established.
          * 
-         * @return bool `true` if the network is available, `false` otherwise.
+         * @param established The new connection state.
          */
-        bool isNetworkAvailable(const std::string& ifname);
+        void setConnectionEstablished(bool established);
 
         /* members */
+        LinkBackend *backend{nullptr};
+        utils::TimerService *timers{nullptr};
+        utils::Wakeup *linkChanged{nullptr};
+        StatusPublisher *status{nullptr};
+        std::function<void(int index, const interface& iface)> onLinkChange;  /* runs from every check */
+        utils::TimerId timer{0};
         std::atomic<bool> isConnectionEstablished;
-        std::thread thread{};
     };
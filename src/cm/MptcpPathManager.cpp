@@ -0,0 +1,170 @@
+#include "MptcpPathManager.h"
+#include "CMLogger.h"
+
+/* std */
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/mptcp.h>
+#include <linux/genetlink.h>
+
+/* Endpoint ids CM owns, kept clear of ids an operator assigns by hand with `ip mptcp`. */
+constexpr uint8_t ENDPOINT_ID_BASE = 200;
+
+MptcpPathManager::MptcpPathManager(uint32_t maxSubflows) {
+    try {
+        socket.reset(new utils::NetlinkSocket(NETLINK_GENERIC));
+    }
+    catch (const std::runtime_error& e) {
+        utils::CMLogger::log(utils::ERROR, "MPTCP path manager unavailable: " + std::string(e.what()));
+        return;
+    }
+
+    family = socket->resolveFamily(MPTCP_PM_NAME);
+    if (family < 0) {
+        utils::CMLogger::log(utils::ERROR, "MPTCP path manager unavailable: " + std::string(strerror(-family)));
+        return;
+    }
+
+    int res = getLimits(savedSubflows, savedAddAddrs);
+    if (res < 0) {
+        utils::CMLogger::log(utils::ERROR, "Failed to read MPTCP limits: " + std::string(strerror(-res)));
+        return;
+    }
+
+    uint32_t subflows = std::max(savedSubflows, maxSubflows);
+    uint32_t addAddrs = std::max(savedAddAddrs, maxSubflows);
+    if (subflows != savedSubflows || addAddrs != savedAddAddrs) {
+        res = setLimits(subflows, addAddrs);
+        if (res < 0) {
+            utils::CMLogger::log(utils::ERROR, "Failed to set MPTCP limits: " + std::string(strerror(-res)));
+            return;
+        }
+        limitsRaised = true;
+    }
+
+    utils::CMLogger::log(utils::INFO, "MPTCP path manager ready, up to " + std::to_string(subflows) + " subflows");
+}
+
+MptcpPathManager::~MptcpPathManager() {
+    for (auto& endpoint : endpoints) {
+        removeEndpoint(endpoint.second);
+    }
+
+    if (limitsRaised) {
+        setLimits(savedSubflows, savedAddAddrs);
+    }
+}
+
+void MptcpPathManager::update(int index, const std::string& ifname, const std::string& address, bool healthy) {
+    if (!isEnabled() || index < 0) return;
+
+    uint8_t id = ENDPOINT_ID_BASE + index;
+    endpoints.erase(index);
+    removeEndpoint(id);     /* ours, or a stale one left behind by a previous run */
+
+    if (!healthy) {
+        utils::CMLogger::log(utils::INFO, "MPTCP endpoint on " + ifname + " removed");
+        return;
+    }
+
+    if (address.empty()) {
+        utils::CMLogger::log(utils::ERROR, "No address on " + ifname + ", no MPTCP endpoint added");
+        return;
+    }
+
+    int res = addEndpoint(id, ifname, address);
+    if (res < 0) {
+        utils::CMLogger::log(utils::ERROR, "Failed to add MPTCP endpoint " + address + " on " + ifname + 
+            ": " + strerror(-res));
+        return;
+    }
+
+    endpoints[index] = id;
+    utils::CMLogger::log(utils::INFO, "MPTCP endpoint " + address + " on " + ifname + " added");
+}
+
+int MptcpPathManager::addEndpoint(uint8_t id, const std::string& ifname, const std::string& address) {
+    in_addr addr4;
+    if (inet_pton(AF_INET, address.c_str(), &addr4) != 1) {
+        return -EINVAL;
+    }
+
+    genlmsghdr genl{};
+    genl.cmd = MPTCP_PM_CMD_ADD_ADDR;
+    genl.version = MPTCP_PM_VER;
+
+    utils::NetlinkMessage message(family, 0, &genl, sizeof(genl));
+    size_t nested = message.beginNested(MPTCP_PM_ATTR_ADDR);
+    message.addAttrU16(MPTCP_PM_ADDR_ATTR_FAMILY, AF_INET);
+    message.addAttrU8(MPTCP_PM_ADDR_ATTR_ID, id);
+    message.addAttr(MPTCP_PM_ADDR_ATTR_ADDR4, &addr4, sizeof(addr4));
+    message.addAttrU32(MPTCP_PM_ADDR_ATTR_IF_IDX, if_nametoindex(ifname.c_str()));
+    message.addAttrU32(MPTCP_PM_ADDR_ATTR_FLAGS, MPTCP_PM_ADDR_FLAG_SUBFLOW);
+    message.endNested(nested);
+
+    return socket->request(message);
+}
+
+int MptcpPathManager::removeEndpoint(uint8_t id) {
+    genlmsghdr genl{};
+    genl.cmd = MPTCP_PM_CMD_DEL_ADDR;
+    genl.version = MPTCP_PM_VER;
+
+    utils::NetlinkMessage message(family, 0, &genl, sizeof(genl));
+    size_t nested = message.beginNested(MPTCP_PM_ATTR_ADDR);
+    message.addAttrU8(MPTCP_PM_ADDR_ATTR_ID, id);
+    message.endNested(nested);
+
+    return socket->request(message);
+}
+
+int MptcpPathManager::getLimits(uint32_t& subflows, uint32_t& addAddrs) {
+    genlmsghdr genl{};
+    genl.cmd = MPTCP_PM_CMD_GET_LIMITS;
+    genl.version = MPTCP_PM_VER;
+
+    utils::NetlinkMessage message(family, 0, &genl, sizeof(genl));
+    std::vector<char> reply;
+    int res = socket->request(message, &reply);
+    if (res < 0) {
+        return res;
+    }
+    if (reply.empty()) {
+        return -ENODATA;
+    }
+
+    subflows = 0;
+    addAddrs = 0;
+    const nlmsghdr *header = reinterpret_cast<const nlmsghdr*>(reply.data());
+    int attrLen = header->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+    const char *attrData = static_cast<const char*>(NLMSG_DATA(header)) + GENL_HDRLEN;
+    while (attrLen >= NLA_HDRLEN) {
+        const nlattr *attr = reinterpret_cast<const nlattr*>(attrData);
+        if (attr->nla_len < NLA_HDRLEN || attr->nla_len > attrLen) break;
+
+        uint32_t value = 0;
+        std::memcpy(&value, attrData + NLA_HDRLEN, std::min<size_t>(sizeof(value), attr->nla_len - NLA_HDRLEN));
+        if ((attr->nla_type & NLA_TYPE_MASK) == MPTCP_PM_ATTR_SUBFLOWS) subflows = value;
+        if ((attr->nla_type & NLA_TYPE_MASK) == MPTCP_PM_ATTR_RCV_ADD_ADDRS) addAddrs = value;
+
+        attrLen -= NLA_ALIGN(attr->nla_len);
+        attrData += NLA_ALIGN(attr->nla_len);
+    }
+
+    return 0;
+}
+
+int MptcpPathManager::setLimits(uint32_t subflows, uint32_t addAddrs) {
+    genlmsghdr genl{};
+    genl.cmd = MPTCP_PM_CMD_SET_LIMITS;
+    genl.version = MPTCP_PM_VER;
+
+    utils::NetlinkMessage message(family, 0, &genl, sizeof(genl));
+    message.addAttrU32(MPTCP_PM_ATTR_SUBFLOWS, subflows);
+    message.addAttrU32(MPTCP_PM_ATTR_RCV_ADD_ADDRS, addAddrs);
+
+    return socket->request(message);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Netlink.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+/**
+ * Keeps the kernel MPTCP path manager's endpoints in sync with the interfaces CM monitors,
+ * so an MPTCP connection to the device opens a subflow on every healthy uplink.
+ * Talks to the in-kernel path manager over generic netlink ("mptcp_pm").
+ */
+class MptcpPathManager {
+public:
+
+    /** 
+     * @brief Resolves the path manager family and raises the namespace's limits to `maxSubflows`.
+     * 
+     * Limits that are already higher are left alone. If the kernel has no MPTCP support the manager stays disabled and every call is a no-op,
+     * connections then simply fall back to single-path TCP.
+     * 
+     * @param maxSubflows Additional subflows allowed per connection.
+     */
+    explicit MptcpPathManager(uint32_t maxSubflows);
+
+    /** 
+     * @brief Removes every endpoint this manager added and restores limits it raised.
+     */
+    ~MptcpPathManager();
+
+    MptcpPathManager(const MptcpPathManager&) = delete;
+    MptcpPathManager& operator=(const MptcpPathManager&) = delete;
+
+    /* methods */
+
+    /** 
+     * @brief Adds or removes the endpoint of the interface at `index` after its health changed.
+     * 
+     * @param index Index of the interface as CM numbers them.
+     * @param ifname The name of the interface.
+     * @param address IPv4 address of the interface, used when `healthy` is set.
+     * @param healthy Whether the interface may carry subflows.
+     */
+    void update(int index, const std::string& ifname, const std::string& address, bool healthy);
+
+    bool isEnabled() const { return family > 0; }
+
+private:
+
+    /* methods */
+
+    /** 
+     * @brief Adds an endpoint with the `subflow` flag for `address` on `ifname`.
+     * 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int addEndpoint(uint8_t id, const std::string& ifname, const std::string& address);
+
+    /** 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int removeEndpoint(uint8_t id);
+
+    /** 
+     * @brief Reads the network namespace's subflow and accepted ADD_ADDR limits.
+     * 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int getLimits(uint32_t& subflows, uint32_t& addAddrs);
+
+    /** 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int setLimits(uint32_t subflows, uint32_t addAddrs);
+
+    /* members */
+    std::unique_ptr<utils::NetlinkSocket> socket;
+    int family{-1};
+    std::map<int, uint8_t> endpoints;
+    uint32_t savedSubflows{0};
+    uint32_t savedAddAddrs{0};
+    bool limitsRaised{false};
+};
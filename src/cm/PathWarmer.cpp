@@ -0,0 +1,154 @@
+#include "PathWarmer.h"
+#include "CMLogger.h"
+
+/* std */
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
+
+/* The discard port: anything answering it, or an ICMP unreachable, still confirms the path. */
+constexpr uint16_t WARM_PORT = 9;
+
+static uint32_t parseAddress(const std::string& address) {
+    in_addr addr;
+    if (inet_pton(AF_INET, address.c_str(), &addr) != 1) {
+        throw std::runtime_error("Invalid address for path warming: " + address);
+    }
+    return addr.s_addr;
+}
+
+PathWarmer::PathWarmer(const std::string& device, const std::vector<WarmedInterface>& interfaces,
+                       std::chrono::milliseconds interval, utils::TimerService& timers)
+    : timers{timers}, listener{NETLINK_ROUTE, RTMGRP_NEIGH}, requests{NETLINK_ROUTE}, deviceAddress{parseAddress(device)}
+{
+    for (const WarmedInterface& iface : interfaces) {
+        uint32_t nextHop = iface.nextHop.empty() ? deviceAddress : parseAddress(iface.nextHop);
+        paths.push_back(WarmedPath{iface, nextHop, false, false});
+    }
+
+    probeSocket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (probeSocket == -1) {
+        throw std::runtime_error("Failed to create keep-warm socket: " + std::string(strerror(errno)));
+    }
+
+    timers.watch(listener.getFd(), [this] { handleNeighborEvents(); });
+    timer = timers.schedulePeriodic(interval, [this] { warmAll(); });
+
+    utils::CMLogger::log(utils::INFO, "Warming standby paths to " + device + " every " + 
+        std::to_string(interval.count()) + " ms");
+}
+
+PathWarmer::~PathWarmer() {
+    timers.cancel(timer);
+    timers.unwatch(listener.getFd());
+    close(probeSocket);
+}
+
+void PathWarmer::setActive(int index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    activeIndex = index;
+}
+
+void PathWarmer::update(int index, bool up) {
+    if (index < 0 || index >= static_cast<int>(paths.size())) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    paths[index].up = up;
+    if (isStandby(index)) {
+        refreshNeighbor(index);
+        sendProbe(index);
+    }
+}
+
+void PathWarmer::warmAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (isStandby(i)) {
+            refreshNeighbor(i);
+            sendProbe(i);
+        }
+    }
+}
+
+void PathWarmer::sendProbe(size_t index) {
+    WarmedPath& path = paths[index];
+    const std::string& ifname = path.iface.ifname;
+
+    int res = setsockopt(probeSocket, SOL_SOCKET, SO_BINDTODEVICE, ifname.c_str(), ifname.size());
+    if (res == 0 && path.iface.fwmark) {
+        res = setsockopt(probeSocket, SOL_SOCKET, SO_MARK, &path.iface.fwmark, sizeof(path.iface.fwmark));
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(WARM_PORT);
+    addr.sin_addr.s_addr = deviceAddress;
+    if (res == 0) {
+        res = sendto(probeSocket, nullptr, 0, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    }
+
+    if (res == -1 && !path.probeFailing) {
+        utils::CMLogger::log(utils::ERROR, "Keep-warm probe through " + ifname + " failed: " + strerror(errno));
+    }
+    path.probeFailing = (res == -1);
+}
+
+void PathWarmer::refreshNeighbor(size_t index) {
+    const WarmedPath& path = paths[index];
+
+    ndmsg ndm{};
+    ndm.ndm_family = AF_INET;
+    ndm.ndm_ifindex = if_nametoindex(path.iface.ifname.c_str());
+    ndm.ndm_flags = NTF_USE;
+    if (ndm.ndm_ifindex == 0) return;
+
+    utils::NetlinkMessage message(RTM_NEWNEIGH, NLM_F_CREATE | NLM_F_REPLACE, &ndm, sizeof(ndm));
+    message.addAttr(NDA_DST, &path.nextHop, sizeof(path.nextHop));
+
+    int res = requests.request(message);
+    if (res < 0) {
+        utils::CMLogger::log(utils::ERROR, "Failed to refresh neighbor on " + path.iface.ifname + ": " + strerror(-res));
+    }
+}
+
+void PathWarmer::handleNeighborEvents() {
+    std::vector<char> buffer;
+    ssize_t len;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    while ((len = listener.receive(buffer)) > 0) {
+        int remaining = len;
+        for (nlmsghdr *hdr = reinterpret_cast<nlmsghdr*>(buffer.data()); NLMSG_OK(hdr, remaining); 
+             hdr = NLMSG_NEXT(hdr, remaining)) {
+            if (hdr->nlmsg_type != RTM_NEWNEIGH) continue;
+
+            ndmsg *ndm = static_cast<ndmsg*>(NLMSG_DATA(hdr));
+            if (ndm->ndm_family != AF_INET || !(ndm->ndm_state & NUD_STALE)) continue;
+
+            int attrLen = hdr->nlmsg_len - NLMSG_LENGTH(sizeof(ndmsg));
+            rtattr *first = reinterpret_cast<rtattr*>(reinterpret_cast<char*>(ndm) + NLMSG_ALIGN(sizeof(ndmsg)));
+            for (rtattr *attr = first; RTA_OK(attr, attrLen); attr = RTA_NEXT(attr, attrLen)) {
+                if (attr->rta_type != NDA_DST || RTA_PAYLOAD(attr) != sizeof(uint32_t)) continue;
+
+                uint32_t dst;
+                std::memcpy(&dst, RTA_DATA(attr), sizeof(dst));
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    if (paths[i].nextHop == dst && isStandby(i) &&
+                        static_cast<int>(if_nametoindex(paths[i].iface.ifname.c_str())) == ndm->ndm_ifindex) {
+                        refreshNeighbor(i);
+                    }
+                }
+            }
+        }
+    }
+
+    if (len < 0 && len != -ENOBUFS) {
+        utils::CMLogger::log(utils::ERROR, "Failed to read neighbor events: " + std::string(strerror(-len)));
+    }
+}
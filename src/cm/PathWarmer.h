@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Netlink.h"
+#include "TimerService.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+struct WarmedInterface {
+    std::string ifname;
+    std::string nextHop;    /* gateway towards the device, or the device itself when on-link */
+    uint32_t fwmark;        /* mark selecting the interface's routing table, 0 if none */
+};
+
+/**
+ * Keeps the paths to the device hot on standby interfaces, so the first packets after a
+ * failover do not wait for neighbor resolution or a modem waking up.
+ *
+ * Neighbor entries of the next hops are watched through `RTM_NEWNEIGH` and refreshed as soon
+ * as they turn stale. Each standby interface also sends one small UDP datagram towards the
+ * device every warm interval, which keeps the entry confirmed and the uplink awake.
+ */
+class PathWarmer {
+public:
+
+    PathWarmer() = delete;
+
+    /** 
+     * @brief Subscribes to neighbor events and schedules the keep-warm probes on `timers`.
+     * 
+     * @param device IPv4 address of the device.
+     * @param interfaces The monitored interfaces, in CM's index order.
+     * @param interval Time between two keep-warm probes on one interface.
+     * @param timers The timer service running the probes and the neighbor listener.
+     */
+    PathWarmer(const std::string& device, const std::vector<WarmedInterface>& interfaces,
+               std::chrono::milliseconds interval, utils::TimerService& timers);
+
+    ~PathWarmer();
+
+    PathWarmer(const PathWarmer&) = delete;
+    PathWarmer& operator=(const PathWarmer&) = delete;
+
+    /* methods */
+
+    /** 
+     * @brief Marks the interface at `index` as active, every other interface up is standby.
+     */
+    void setActive(int index);
+
+    /** 
+     * @brief Records the link state of the interface at `index` and warms it right away when it comes up.
+     */
+    void update(int index, bool up);
+
+private:
+
+    struct WarmedPath {
+        WarmedInterface iface;
+        uint32_t nextHop;       /* network byte order */
+        bool up;
+        bool probeFailing;
+    };
+
+    /* methods */
+
+    /** 
+     * @brief Sends a keep-warm probe and a neighbor refresh on every standby interface.
+     */
+    void warmAll();
+
+    /** 
+     * @brief Sends one keep-warm datagram to the device through the path at `index`.
+     */
+    void sendProbe(size_t index);
+
+    /** 
+     * @brief Asks the kernel to (re)resolve the next hop of the path at `index` (`NTF_USE`).
+     */
+    void refreshNeighbor(size_t index);
+
+    /** 
+     * @brief Drains the neighbor listener and refreshes standby entries that turned stale.
+     */
+    void handleNeighborEvents();
+
+    bool isStandby(size_t index) const { return paths[index].up && static_cast<int>(index) != activeIndex; }
+
+    /* members */
+    utils::TimerService& timers;
+    utils::NetlinkSocket listener;
+    utils::NetlinkSocket requests;
+    std::mutex mutex;
+    std::vector<WarmedPath> paths;
+    uint32_t deviceAddress;     /* network byte order */
+    int activeIndex{-1};
+    int probeSocket{-1};
+    utils::TimerId timer{0};
+};
@@ -0,0 +1,168 @@
+#include "PolicyRouter.h"
+#include "CMLogger.h"
+
+/* std */
+#include <cstring>
+#include <stdexcept>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+#include <linux/fib_rules.h>
+
+constexpr uint32_t RULE_PRIORITY = 1000;
+
+PolicyRouter::PolicyRouter(const std::string& device, const std::vector<RoutedInterface>& interfaces, uint32_t activeTable)
+    : socket{NETLINK_ROUTE}, interfaces{interfaces}, activeTable{activeTable}
+{
+    in_addr addr;
+    if (inet_pton(AF_INET, device.c_str(), &addr) != 1) {
+        throw std::runtime_error("Invalid device address for policy routing: " + device);
+    }
+    deviceAddress = addr.s_addr;
+
+    for (size_t i = 0; i < interfaces.size(); ++i) {
+        int res = changeRule(RTM_NEWRULE, interfaceTable(i), RULE_PRIORITY + i, interfaceTable(i));
+        if (res < 0 && res != -EEXIST) {
+            utils::CMLogger::log(utils::ERROR, "Failed to add fwmark rule for " + interfaces[i].ifname + 
+                ": " + strerror(-res));
+        }
+        createdRules.push_back(res == 0);
+    }
+
+    int res = changeRule(RTM_NEWRULE, activeTable, RULE_PRIORITY + interfaces.size(), 0);
+    if (res < 0 && res != -EEXIST) {
+        throw std::runtime_error("Failed to add device rule: " + std::string(strerror(-res)));
+    }
+    createdRules.push_back(res == 0);
+
+    utils::CMLogger::log(utils::INFO, "Policy routing for " + device + " through table " + std::to_string(activeTable));
+}
+
+PolicyRouter::~PolicyRouter() {
+    for (uint32_t table : createdRoutes) {
+        removeRoute(table);
+    }
+
+    if (createdRules[interfaces.size()]) {
+        changeRule(RTM_DELRULE, activeTable, RULE_PRIORITY + interfaces.size(), 0);
+    }
+    for (size_t i = 0; i < interfaces.size(); ++i) {
+        if (createdRules[i]) {
+            changeRule(RTM_DELRULE, interfaceTable(i), RULE_PRIORITY + i, interfaceTable(i));
+        }
+    }
+}
+
+bool PolicyRouter::switchTo(int index) {
+    if (index < 0 || index >= static_cast<int>(interfaces.size())) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    int res = installRoute(activeTable, index);
+    if (res < 0) {
+        utils::CMLogger::log(utils::ERROR, "Failed to switch device route to " + interfaces[index].ifname + 
+            ": " + strerror(-res));
+        return false;
+    }
+
+    activeIndex = index;
+    utils::CMLogger::log(utils::INFO, "Device route switched to " + interfaces[index].ifname);
+    return true;
+}
+
+void PolicyRouter::update(int index, bool up) {
+    if (index < 0 || index >= static_cast<int>(interfaces.size()) || !up) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    int res = installRoute(interfaceTable(index), index);
+    if (res < 0) {
+        utils::CMLogger::log(utils::ERROR, "Failed to install device route through " + interfaces[index].ifname + 
+            ": " + strerror(-res));
+    }
+
+    if (index == activeIndex) {
+        installRoute(activeTable, index);
+    }
+}
+
+int PolicyRouter::installRoute(uint32_t table, int index) {
+    if (createdRoutes.count(table)) {
+        return writeRoute(table, index, NLM_F_CREATE | NLM_F_REPLACE);
+    }
+
+    int res = writeRoute(table, index, NLM_F_CREATE | NLM_F_EXCL);
+    if (res == 0) {
+        createdRoutes.insert(table);
+    }
+    else if (res == -EEXIST) {
+        utils::CMLogger::log(utils::ERROR, "Table " + std::to_string(table) + 
+            " already routes the device, taking it over but leaving it in place on exit");
+        res = writeRoute(table, index, NLM_F_CREATE | NLM_F_REPLACE);
+    }
+
+    return res;
+}
+
+int PolicyRouter::writeRoute(uint32_t table, int index, uint16_t flags) {
+    const RoutedInterface& iface = interfaces[index];
+    unsigned int ifindex = if_nametoindex(iface.ifname.c_str());
+    if (ifindex == 0) {
+        return -errno;
+    }
+
+    rtmsg rtm{};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = 32;
+    rtm.rtm_table = RT_TABLE_UNSPEC;
+    rtm.rtm_protocol = RTPROT_STATIC;
+    rtm.rtm_scope = iface.gateway.empty() ? RT_SCOPE_LINK : RT_SCOPE_UNIVERSE;
+    rtm.rtm_type = RTN_UNICAST;
+
+    utils::NetlinkMessage message(RTM_NEWROUTE, flags, &rtm, sizeof(rtm));
+    message.addAttrU32(RTA_TABLE, table);
+    message.addAttr(RTA_DST, &deviceAddress, sizeof(deviceAddress));
+    message.addAttrU32(RTA_OIF, ifindex);
+    if (!iface.gateway.empty()) {
+        in_addr gateway;
+        if (inet_pton(AF_INET, iface.gateway.c_str(), &gateway) != 1) {
+            return -EINVAL;
+        }
+        message.addAttr(RTA_GATEWAY, &gateway, sizeof(gateway));
+    }
+
+    return socket.request(message);
+}
+
+int PolicyRouter::removeRoute(uint32_t table) {
+    rtmsg rtm{};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = 32;
+    rtm.rtm_table = RT_TABLE_UNSPEC;
+    rtm.rtm_scope = RT_SCOPE_NOWHERE;
+
+    utils::NetlinkMessage message(RTM_DELROUTE, 0, &rtm, sizeof(rtm));
+    message.addAttrU32(RTA_TABLE, table);
+    message.addAttr(RTA_DST, &deviceAddress, sizeof(deviceAddress));
+
+    return socket.request(message);
+}
+
+int PolicyRouter::changeRule(uint16_t type, uint32_t table, uint32_t priority, uint32_t fwmark) {
+    fib_rule_hdr frh{};
+    frh.family = AF_INET;
+    frh.action = FR_ACT_TO_TBL;
+    frh.table = RT_TABLE_UNSPEC;
+    frh.dst_len = fwmark ? 0 : 32;
+
+    utils::NetlinkMessage message(type, type == RTM_NEWRULE ? NLM_F_CREATE | NLM_F_EXCL : 0, &frh, sizeof(frh));
+    message.addAttrU32(FRA_TABLE, table);
+    message.addAttrU32(FRA_PRIORITY, priority);
+    if (fwmark) {
+        message.addAttrU32(FRA_FWMARK, fwmark);
+        message.addAttrU32(FRA_FWMASK, 0xffffffff);
+    }
+    else {
+        message.addAttr(FRA_DST, &deviceAddress, sizeof(deviceAddress));
+    }
+
+    return socket.request(message);
+}
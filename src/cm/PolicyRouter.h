@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Netlink.h"
+
+#include <set>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct RoutedInterface {
+    std::string ifname;
+    std::string gateway;    /* empty when the device is on the interface's link */
+};
+
+/**
+ * Steers all device-bound traffic on the host through the interface CM selected.
+ *
+ * Every interface gets its own table holding a route to the device, reachable with
+ * `fwmark <table>`. A rule sends everything addressed to the device to the active table,
+ * whose single route is swapped with one `RTM_NEWROUTE`/`NLM_F_REPLACE` on failover.
+ */
+class PolicyRouter {
+public:
+
+    PolicyRouter() = delete;
+
+    /** 
+     * @brief Installs the per-interface tables' rules and the device rule.
+     * 
+     * @param device IPv4 address of the device.
+     * @param interfaces The monitored interfaces, in CM's index order.
+     * @param activeTable Table the device rule points to; interface `i` uses `activeTable + 1 + i`.
+     */
+    PolicyRouter(const std::string& device, const std::vector<RoutedInterface>& interfaces, uint32_t activeTable);
+
+    /** 
+     * @brief Removes the rules and routes this router created, leaving ones that already existed.
+     */
+    ~PolicyRouter();
+
+    PolicyRouter(const PolicyRouter&) = delete;
+    PolicyRouter& operator=(const PolicyRouter&) = delete;
+
+    /* methods */
+
+    /** 
+     * @brief Points the device route of the active table at the interface at `index`.
+     * 
+     * @param index Index of the newly selected interface.
+     * 
+     * @return bool `true` if the route was switched.
+     */
+    bool switchTo(int index);
+
+    /** 
+     * @brief Reinstalls the routes through the interface at `index` after its link came back.
+     * 
+     * @param index Index of the interface.
+     * @param up Whether the link is up.
+     */
+    void update(int index, bool up);
+
+private:
+
+    /* methods */
+
+    /** 
+     * @brief Adds or replaces the device route through `interfaces[index]` in `table`.
+     * 
+     * The first install in a table is exclusive, so a route that was already there is
+     * replaced but not recorded as created.
+     * 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int installRoute(uint32_t table, int index);
+
+    /** 
+     * @brief Sends one `RTM_NEWROUTE` for the device route through `interfaces[index]`.
+     * 
+     * @param flags `NLM_F_*` creation flags of the request.
+     * 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int writeRoute(uint32_t table, int index, uint16_t flags);
+
+    /** 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int removeRoute(uint32_t table);
+
+    /** 
+     * @brief Adds (`RTM_NEWRULE`) or removes (`RTM_DELRULE`) a rule to `table`.
+     * 
+     * @param type `RTM_NEWRULE` or `RTM_DELRULE`.
+     * @param table Table the rule looks up.
+     * @param priority Rule priority.
+     * @param fwmark Matched mark, 0 to match the device address instead.
+     * 
+     * @return int 0 on success, negative errno on failure.
+     */
+    int changeRule(uint16_t type, uint32_t table, uint32_t priority, uint32_t fwmark);
+
+    uint32_t interfaceTable(int index) const { return activeTable + 1 + index; }
+
+    /* members */
+    utils::NetlinkSocket socket;
+    std::mutex mutex;
+    uint32_t deviceAddress;     /* network byte order */
+    std::vector<RoutedInterface> interfaces;
+    uint32_t activeTable;
+    int activeIndex{-1};
+    std::vector<bool> createdRules;     /* per interface, then the device rule */
+    std::set<uint32_t> createdRoutes;   /* tables whose device route this router created */
+};
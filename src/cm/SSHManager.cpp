@@ -9,8 +9,28 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
-
-constexpr int TIMEOUT = 5;
+#include <netinet/tcp.h>
+#include <linux/mptcp.h>
+#include <sys/select.h>
+#include <algorithm>
+
+#ifndef IPPROTO_MPTCP
+#define IPPROTO_MPTCP 262
+#endif
+
+#ifndef SOL_MPTCP
+#define SOL_MPTCP 284
+#endif
+
+constexpr std::chrono::milliseconds MIN_LIVENESS_SLICE{10};
+constexpr uint32_t MAX_SUBFLOW_INFO = 8;
+
+static timeval toTimeval(std::chrono::milliseconds duration) {
+    timeval tv;
+    tv.tv_sec = duration.count() / 1000;
+    tv.tv_usec = (duration.count() % 1000) * 1000;
+    return tv;
+}
 
 SSHManager::SSHManager() {
     int res = libssh2_init(0);
@@ -20,14 +40,14 @@ SSHManager::SSHManager() {
 }
 
 SSHManager::~SSHManager() {
-    if (!this->session) {
+    if (session) {
         libssh2_session_free(session);
     }
 
     libssh2_exit();
 }
 
-SSHManager::SSHManager(CredentialsSSH credentials) : credentials{credentials} {
+SSHManager::SSHManager(CredentialsSSH credentials, SSHOptions options) : credentials{credentials}, options{options} {
     int res = libssh2_init(0);
     if (res != 0) {
         throw std::runtime_error("Failed to initialize libssh2: " + std::to_string(res));
@@ -35,23 +55,159 @@ SSHManager::SSHManager(CredentialsSSH credentials) : credentials{credentials} {
 
 }
 
-bool SSHManager::waitWithTimeout(int seconds) {
-    fd_set fdset;
-    struct timeval timeout;
+void SSHManager::waitSocket() {
+    checkLiveness(true);
 
-    FD_ZERO(&fdset);
-    FD_SET(socketfd, &fdset);
+    fd_set readfds, writefds;
+    FD_ZERO(&readfds);
+    FD_ZERO(&writefds);
 
-    timeout.tv_sec = seconds;
-    timeout.tv_usec = 0;
+    int directions = libssh2_session_block_directions(session);
+    if (directions & LIBSSH2_SESSION_BLOCK_INBOUND) FD_SET(socketfd, &readfds);
+    if (directions & LIBSSH2_SESSION_BLOCK_OUTBOUND) FD_SET(socketfd, &writefds);
 
-    int ret = select(socketfd + 1, &fdset, nullptr, nullptr, &timeout);
-    return ret > 0;
+    timeval timeout = toTimeval(livenessSlice());
+    select(socketfd + 1, &readfds, &writefds, nullptr, &timeout);
+}
+
+bool SSHManager::waitInput(std::string& line) {
+    std::array<char, 4096> buffer;
+
+    while (true) {
+        size_t newline = pendingInput.find('\n');
+        if (newline != std::string::npos) {
+            line = pendingInput.substr(0, newline);
+            pendingInput.erase(0, newline + 1);
+            return true;
+        }
+        if (inputClosed) {
+            line.swap(pendingInput);
+            pendingInput.clear();
+            return !line.empty();
+        }
+
+        checkLiveness(false);
+
+        fd_set fdset;
+        FD_ZERO(&fdset);
+        FD_SET(STDIN_FILENO, &fdset);
+
+        timeval timeout = toTimeval(livenessSlice());
+        int ret = select(STDIN_FILENO + 1, &fdset, nullptr, nullptr, &timeout);
+        if (ret > 0) {
+            ssize_t nbytes = read(STDIN_FILENO, buffer.data(), buffer.size());
+            if (nbytes > 0) {
+                pendingInput.append(buffer.data(), nbytes);
+            }
+            else if (nbytes == 0) {
+                inputClosed = true;
+            }
+            else if (errno != EINTR && errno != EAGAIN) {
+                throw std::runtime_error("Failed to read input: " + std::string(strerror(errno)));
+            }
+        }
+        else if (ret < 0 && errno != EINTR) {
+            throw std::runtime_error("Failed to wait for input: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+void SSHManager::checkLiveness(bool expectingData) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastLivenessCheck < livenessSlice()) {
+        return;
+    }
+    lastLivenessCheck = now;
+
+    /* A keepalive while a send is still pending would be refused as bad use, not a dead peer. */
+    if (!(libssh2_session_block_directions(session) & LIBSSH2_SESSION_BLOCK_OUTBOUND)) {
+        int secondsToNext;
+        int res = libssh2_keepalive_send(session, &secondsToNext);
+        if (res < 0 && res != LIBSSH2_ERROR_EAGAIN && res != LIBSSH2_ERROR_BAD_USE) {
+            throw SessionDeadError("Failed to send keepalive: " + std::to_string(res));
+        }
+    }
+
+    std::chrono::milliseconds sinceReceive{0};
+    std::chrono::microseconds rtt{0};
+    if (!readTcpInfo(sinceReceive, rtt)) {
+        if (!expectingData) {
+            lastReceive = now;
+        }
+        sinceReceive = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastReceive);
+    }
+
+    bool alive = sinceReceive <= options.sessionDeadline;
+    if (onLiveness) {
+        onLiveness(alive, rtt);
+    }
+
+    if (!alive) {
+        throw SessionDeadError("Nothing received from " + credentials.ip + " for " + 
+            std::to_string(sinceReceive.count()) + " ms, session declared dead");
+    }
+}
+
+bool SSHManager::readTcpInfo(std::chrono::milliseconds& sinceReceive, std::chrono::microseconds& rtt) const {
+    if (options.useMptcp && readSubflowInfo(sinceReceive, rtt)) {
+        return true;
+    }
+
+    tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(socketfd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+        sinceReceive = std::chrono::milliseconds(info.tcpi_last_data_recv);
+        rtt = std::chrono::microseconds(info.tcpi_rtt);
+        return true;
+    }
+
+    return false;
+}
+
+bool SSHManager::readSubflowInfo(std::chrono::milliseconds& sinceReceive, std::chrono::microseconds& rtt) const {
+    struct {
+        mptcp_subflow_data header;
+        tcp_info subflows[MAX_SUBFLOW_INFO];
+    } mptcpInfo{};
+    mptcpInfo.header.size_subflow_data = sizeof(mptcpInfo.header);
+    mptcpInfo.header.size_user = sizeof(tcp_info);
+    socklen_t len = sizeof(mptcpInfo);
+    if (getsockopt(socketfd, SOL_MPTCP, MPTCP_TCPINFO, &mptcpInfo, &len) != 0 || 
+        mptcpInfo.header.num_subflows == 0) {
+        return false;
+    }
+
+    const tcp_info *latest = &mptcpInfo.subflows[0];
+    for (uint32_t i = 1; i < std::min(mptcpInfo.header.num_subflows, MAX_SUBFLOW_INFO); ++i) {
+        if (mptcpInfo.subflows[i].tcpi_last_data_recv < latest->tcpi_last_data_recv) {
+            latest = &mptcpInfo.subflows[i];
+        }
+    }
+
+    sinceReceive = std::chrono::milliseconds(latest->tcpi_last_data_recv);
+    rtt = std::chrono::microseconds(latest->tcpi_rtt);
+    return true;
+}
+
+std::chrono::milliseconds SSHManager::livenessSlice() const {
+    std::chrono::milliseconds slice = std::min<std::chrono::milliseconds>(
+        std::chrono::seconds(options.keepaliveInterval), options.sessionDeadline / 4);
+    return std::max(slice, MIN_LIVENESS_SLICE);
 }
 
 int SSHManager::authenticate() {
     int res{0};
-    socketfd = socket(AF_INET, SOCK_STREAM, 0);
+    socketfd = -1;
+    if (options.useMptcp) {
+        socketfd = socket(AF_INET, SOCK_STREAM, IPPROTO_MPTCP);
+        if (socketfd < 0) {
+            utils::CMLogger::log(utils::ERROR, "MPTCP socket unavailable, falling back to TCP: " + 
+                std::string(strerror(errno)));
+        }
+    }
+    if (socketfd < 0) {
+        socketfd = socket(AF_INET, SOCK_STREAM, 0);
+    }
     if (socketfd < 0) {
         utils::CMLogger::log(utils::ERROR, "Failed to create socket");
         return socketfd;
@@ -69,9 +225,14 @@ int SSHManager::authenticate() {
     if (res <= 0) {
         utils::CMLogger::log(utils::ERROR, "Invalid IP address");
         close(socketfd);
-        return res;
+        return -1;
     }
 
+    /* Linux applies the send timeout to a blocking connect, it is cleared again once connected. */
+    timeval deadline = toTimeval(options.sessionDeadline);
+    setsockopt(socketfd, SOL_SOCKET, SO_SNDTIMEO, &deadline, sizeof(deadline));
+
+    auto started = std::chrono::steady_clock::now();
     res = connect(socketfd, (struct sockaddr*)&sockaddr, sizeof(sockaddr));
     if (res != 0) {
         utils::CMLogger::log(utils::ERROR, "Failed to connect to device: " + std::string(strerror(errno)));
@@ -79,6 +240,14 @@ int SSHManager::authenticate() {
         return res;
     }
 
+    auto connected = std::chrono::steady_clock::now();
+    timings.connect = connected - started;
+
+    timeval none{};
+    setsockopt(socketfd, SOL_SOCKET, SO_SNDTIMEO, &none, sizeof(none));
+
+    /* Handshake and authentication poll inside libssh2, which only gives up at the session timeout. */
+    libssh2_session_set_timeout(session, options.sessionDeadline.count());
     res = libssh2_session_handshake(session, socketfd);
     if (res) {
         utils::CMLogger::log(utils::ERROR, "Failed to establish SSH connection: " + std::to_string(res));
@@ -86,6 +255,9 @@ int SSHManager::authenticate() {
         return res;
     }
 
+    auto handshaken = std::chrono::steady_clock::now();
+    timings.handshake = handshaken - connected;
+
     res = libssh2_userauth_password(session, credentials.user.c_str(), credentials.password.c_str());
     if (res) {
         utils::CMLogger::log(utils::ERROR, "Authentication failed: " + std::to_string(res));
@@ -93,84 +265,128 @@ int SSHManager::authenticate() {
         return res;
     }
 
+    timings.auth = std::chrono::steady_clock::now() - handshaken;
+
+    libssh2_keepalive_config(session, 1, options.keepaliveInterval);
+    libssh2_session_set_blocking(session, 0);
+    lastReceive = std::chrono::steady_clock::now();
+    lastLivenessCheck = std::chrono::steady_clock::time_point{};
+
     return res;
 }
 
 void SSHManager::enterSSH() {
-    LIBSSH2_CHANNEL *channel;
-
     while (true) {
-        int res;
         std::string userInput;
-        std::array<char, 8192> buffer;
-        int nbytes;
-
-        channel = libssh2_channel_open_session(session);
-        if (!channel) {
-            throw std::runtime_error("Failed to open channel");
-        }
 
-        std::cout << credentials.user << "@" << credentials.password << ":";
-        std::getline(std::cin, userInput);
-
-        if (userInput == "exit") {
+        std::cout << credentials.user << "@" << credentials.password << ":" << std::flush;
+        if (!waitInput(userInput) || userInput == "exit") {
             std::cout << "Device shell exited..." << std::endl;
             break;
         }
 
-        if (!waitWithTimeout(2 * TIMEOUT)) {
-            throw std::runtime_error("Failed to execute command: " + std::to_string(res));
-            break;
-        }
+        execute(userInput, std::cout);
+    }
+}
+
+void SSHManager::execute(const std::string& command, std::ostream& out) {
+    LIBSSH2_CHANNEL *channel;
+    std::array<char, 8192> buffer;
+    ssize_t nbytes;
+    int res;
+
+    lastReceive = std::chrono::steady_clock::now();
 
-        res = libssh2_channel_exec(channel, userInput.c_str());
-        if (res) {
-            throw std::runtime_error("Failed to execute command: " + std::to_string(res));
+    while (!(channel = libssh2_channel_open_session(session))) {
+        if (libssh2_session_last_errno(session) != LIBSSH2_ERROR_EAGAIN) {
+            throw std::runtime_error("Failed to open channel");
         }
+        waitSocket();
+    }
+
+    while ((res = libssh2_channel_exec(channel, command.c_str())) == LIBSSH2_ERROR_EAGAIN) {
+        waitSocket();
+    }
+    if (res) {
+        throw std::runtime_error("Failed to execute command: " + std::to_string(res));
+    }
 
-        while ((nbytes = libssh2_channel_read(channel, buffer.data(), buffer.size())) > 0) {
-            std::cout.write(buffer.data(), nbytes);
+    while (true) {
+        nbytes = libssh2_channel_read(channel, buffer.data(), buffer.size());
+        if (nbytes > 0) {
+            lastReceive = std::chrono::steady_clock::now();
+            out.write(buffer.data(), nbytes);
+        }
+        else if (nbytes == LIBSSH2_ERROR_EAGAIN) {
+            waitSocket();
+        }
+        else if (nbytes == 0 && libssh2_channel_eof(channel)) {
+            break;
         }
-        if (nbytes < 0) {
+        else if (nbytes < 0) {
             throw std::runtime_error("Error reading channel: " + std::to_string(nbytes) +
                                      ", " + std::to_string(libssh2_session_last_error(session, nullptr, nullptr, 0)));
         }
+    }
 
-        res = libssh2_channel_wait_eof(channel);
-        if (res < 0) {
-            throw std::runtime_error("Error waiting for EOF: " + std::to_string(res));
-        }
+    while ((res = libssh2_channel_wait_eof(channel)) == LIBSSH2_ERROR_EAGAIN) {
+        waitSocket();
+    }
+    if (res < 0) {
+        throw std::runtime_error("Error waiting for EOF: " + std::to_string(res));
+    }
 
-        res = libssh2_channel_wait_closed(channel);
-        if (res < 0) {
-            throw std::runtime_error("Error waiting for channel close: " + std::to_string(res));
-        }
+    while ((res = libssh2_channel_wait_closed(channel)) == LIBSSH2_ERROR_EAGAIN) {
+        waitSocket();
+    }
+    if (res < 0) {
+        throw std::runtime_error("Error waiting for channel close: " + std::to_string(res));
+    }
 
-        libssh2_channel_free(channel);
+    while (libssh2_channel_free(channel) == LIBSSH2_ERROR_EAGAIN) {
+        waitSocket();
     }
-    
-    if (channel) libssh2_channel_free(channel);
 }
 
-void SSHManager::connectToDeviceSSH(MonitorThread& monitorThread) {
+void SSHManager::openSession() {
     session = libssh2_session_init();
     if (!session) {
         throw std::runtime_error("Failed to create SSH session");
     }
 
     int res = authenticate();
-    if (res == -1) {
+    if (res != 0) {
+        libssh2_session_free(session);
+        session = nullptr;
         throw std::runtime_error("Failed to connect device: " + std::to_string(res));
     }
 
-    utils::CMLogger::log(utils::INFO, "Successfully connected to device!");
+    utils::CMLogger::log(utils::INFO, "Successfully connected to device in " + 
+        std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+            timings.connect + timings.handshake + timings.auth).count()) + " ms");
+}
+
+void SSHManager::closeSession() {
+    if (!session) return;
+
+    close(socketfd);
+    libssh2_session_free(session);
+    session = nullptr;
+}
+
+void SSHManager::connectToDeviceSSH(MonitorThread& monitorThread) {
+    openSession();
 
     std::cout << "Successfully connected to device!" << std::endl;
-    monitorThread.isConnectionEstablished.store(true);
-    enterSSH();
+    monitorThread.setConnectionEstablished(true);
+    try {
+        enterSSH();
+    }
+    catch (const std::runtime_error& e) {
+        closeSession();
+        throw;
+    }
 
-    close(socketfd);
+    closeSession();
     utils::CMLogger::log(utils::INFO, "Session of connection ended!");
-
-    libssh2_session_free(session);
 }
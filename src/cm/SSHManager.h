@@ -4,6 +4,24 @@
 #include "MonitorThread.h"
 #include <libssh2.h>
 
+#include <chrono>
+#include <ostream>
+#include <stdexcept>
+#include <functional>
+
+/**
+ * Thrown when a live session misses its liveness deadline, so the caller can fail over.
+ */
+struct SessionDeadError : std::runtime_error {
+    explicit SessionDeadError(const std::string& what) : std::runtime_error(what) {}
+};
+
+struct SessionTimings {
+    std::chrono::steady_clock::duration connect;
+    std::chrono::steady_clock::duration handshake;
+    std::chrono::steady_clock::duration auth;
+};
+
 class SSHManager {
 public:
 
@@ -13,7 +31,7 @@ public:
 
     ~SSHManager();
 
-    SSHManager(CredentialsSSH credentials);
+    SSHManager(CredentialsSSH credentials, SSHOptions options);
 
     const CredentialsSSH& getCredentials() { return credentials; }
 
@@ -24,23 +42,100 @@ public:
      * any necessary initialization for the SSH connection.
      * 
      * @param credentials The SSH credentials needed to establish the connection.
+     * 
+     * @throws SessionDeadError if the session misses its liveness deadline.
      */
     void connectToDeviceSSH(MonitorThread& monitorThread);
+
+    /** 
+     * @brief Connects, performs the SSH handshake and authenticates, without entering the shell.
+     * 
+     * Per-phase durations are available from `getTimings` afterwards.
+     * 
+     * @throws std::runtime_error if any phase fails.
+     */
+    void openSession();
+
+    /** 
+     * @brief Closes the socket and frees the session opened by `openSession`.
+     */
+    void closeSession();
+
+    /** 
+     * @brief Runs `command` on its own channel and copies its output to `out`.
+     * 
+     * @param command The command line to execute.
+     * @param out Stream receiving the command's stdout.
+     * 
+     * @throws SessionDeadError if the session misses its liveness deadline meanwhile.
+     */
+    void execute(const std::string& command, std::ostream& out);
+
+    const SessionTimings& getTimings() const { return timings; }
+
+    /* members */
+
+    /* Called on every liveness check of a live session with the result and the kernel's RTT estimate. */
+    std::function<void(bool alive, std::chrono::microseconds rtt)> onLiveness;
 private:
 
     /* methods */
 
     /**
-     * @brief Waits for data on a socket with a specified timeout in seconds.
+     * @brief Waits until the socket is ready in the direction libssh2 is blocked on.
      * 
-     * This function blocks the calling thread, waiting for data to be available on the specified socket. 
+     * Used whenever a non-blocking libssh2 call returns `LIBSSH2_ERROR_EAGAIN`. The wait is
+     * bounded by the liveness slice, and every call runs `checkLiveness` first, expecting data.
+     */
+    void waitSocket();
+
+    /** 
+     * @brief Reads a line from stdin while keeping the session alive.
+     * 
+     * Reads the descriptor directly rather than through `std::cin`, whose buffer would hold
+     * piped lines that `select` no longer reports.
      * 
-     * @param socketfd The file descriptor of the socket to wait on.
-     * @param seconds The timeout period in seconds to wait for data.
+     * @param line Receives the line.
      * 
-     * @return `true` if data is available within the timeout, `false` otherwise.
+     * @return bool `false` when stdin is closed.
+     */
+    bool waitInput(std::string& line);
+
+    /** 
+     * @brief Sends a keepalive if one is due and checks that the peer answered recently.
+     * 
+     * The time since the last received data comes from the kernel (`readTcpInfo`). Without it,
+     * only the last channel read is known, which says nothing while the shell is idle, so the
+     * deadline is then only enforced while a command waits for output. Runs at most once per
+     * liveness slice.
+     * 
+     * @param expectingData `true` while a command is running, `false` at the idle prompt.
+     * 
+     * @throws SessionDeadError if nothing was received within the session deadline.
+     */
+    void checkLiveness(bool expectingData);
+
+    /** 
+     * @brief Reads the time since data last arrived and the RTT estimate from the kernel.
+     * 
+     * In MPTCP mode the subflows are asked first, since `TCP_INFO` on an MPTCP socket only
+     * covers the first subflow. `TCP_INFO` covers plain TCP, including an MPTCP fallback.
+     * 
+     * @return bool `false` if the kernel provides neither.
+     */
+    bool readTcpInfo(std::chrono::milliseconds& sinceReceive, std::chrono::microseconds& rtt) const;
+
+    /** 
+     * @brief Reads `MPTCP_TCPINFO` and reports the subflow that received data most recently.
+     * 
+     * @return bool `false` if the socket is not a multipath connection.
+     */
+    bool readSubflowInfo(std::chrono::milliseconds& sinceReceive, std::chrono::microseconds& rtt) const;
+
+    /** 
+     * @brief Returns the longest CM waits between two liveness checks.
      */
-    bool waitWithTimeout(int seconds);
+    std::chrono::milliseconds livenessSlice() const;
 
     /** 
      * @brief Authenticates the SSH session with the provided credentials.
@@ -69,6 +164,12 @@ private:
 
     /* members */
     int socketfd;
-    LIBSSH2_SESSION *session;
+    LIBSSH2_SESSION *session{nullptr};
     CredentialsSSH credentials;
+    SSHOptions options;
+    SessionTimings timings{};
+    std::string pendingInput;   /* read from stdin but not yet returned as a line */
+    bool inputClosed{false};
+    std::chrono::steady_clock::time_point lastReceive;
+    std::chrono::steady_clock::time_point lastLivenessCheck;
 };
\ No newline at end of file
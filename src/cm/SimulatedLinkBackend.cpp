@@ -0,0 +1,109 @@
+#include "SimulatedLinkBackend.h"
+#include "CMLogger.h"
+
+/* std */
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+constexpr std::chrono::milliseconds PROBE_TIMEOUT{1000};
+
+SimulatedLinkBackend::SimulatedLinkBackend(const std::string& tracePath, utils::Clock& clock, uint32_t seed) 
+    : clock{clock}, rng{seed}
+{
+    loadTrace(tracePath);
+    utils::CMLogger::log(utils::INFO, "Simulating links from " + tracePath + 
+        " (" + std::to_string(traceEnd.count()) + " ms, " + 
+        (clock.getSpeed() > 0 ? "paced at " + std::to_string(clock.getSpeed()) + "x)" : "unpaced)"));
+}
+
+void SimulatedLinkBackend::loadTrace(const std::string& tracePath) {
+    std::ifstream file(tracePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open the trace " + tracePath);
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream lineStream(line);
+        long long time;
+        std::string ifname, state;
+        if (!(lineStream >> time)) continue;
+
+        if (!(lineStream >> ifname >> state) || (state != "up" && state != "down")) {
+            throw std::runtime_error("Malformed trace line " + std::to_string(lineNumber) + " in " + tracePath);
+        }
+
+        std::vector<LinkEvent>& events = trace[ifname];
+        LinkEvent event{std::chrono::milliseconds(time), state == "up", std::chrono::milliseconds(0), 0.0};
+        if (!events.empty()) {
+            event.rtt = events.back().rtt;
+            event.loss = events.back().loss;
+        }
+
+        long long rtt;
+        double loss;
+        if (lineStream >> rtt) {
+            event.rtt = std::chrono::milliseconds(rtt);
+            if (lineStream >> loss) {
+                event.loss = loss / 100;
+            }
+        }
+
+        events.push_back(event);
+        traceEnd = std::max(traceEnd, event.time);
+    }
+
+    for (auto& entry : trace) {
+        std::stable_sort(entry.second.begin(), entry.second.end(), 
+            [](const LinkEvent& a, const LinkEvent& b) { return a.time < b.time; });
+    }
+}
+
+const SimulatedLinkBackend::LinkEvent* SimulatedLinkBackend::currentEvent(const std::string& ifname) const {
+    auto it = trace.find(ifname);
+    if (it == trace.end()) {
+        return nullptr;
+    }
+
+    const std::vector<LinkEvent>& events = it->second;
+    auto next = std::upper_bound(events.begin(), events.end(), clock.now(),
+        [](std::chrono::milliseconds time, const LinkEvent& event) { return time < event.time; });
+
+    return next == events.begin() ? nullptr : &*(next - 1);
+}
+
+bool SimulatedLinkBackend::isLinkUp(const std::string& ifname) {
+    const LinkEvent *event = currentEvent(ifname);
+    return event && event->up;
+}
+
+ProbeResult SimulatedLinkBackend::probe(const std::string& ifname, const std::string& /* ip */) {
+    const LinkEvent *event = currentEvent(ifname);
+    bool lost;
+    {
+        std::lock_guard<std::mutex> lock(rngMutex);
+        lost = std::uniform_real_distribution<double>(0.0, 1.0)(rng) < (event ? event->loss : 0.0);
+    }
+
+    if (!event || !event->up || lost) {
+        clock.sleepFor(PROBE_TIMEOUT);
+        return {false, std::chrono::microseconds(0)};
+    }
+
+    clock.sleepFor(event->rtt);
+    return {true, event->rtt};
+}
+
+std::string SimulatedLinkBackend::resolveAddress(const std::string& ifname) {
+    return trace.count(ifname) ? ifname : "";
+}
+
+bool SimulatedLinkBackend::finished() {
+    return clock.now() > traceEnd;
+}
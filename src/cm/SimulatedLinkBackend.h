@@ -0,0 +1,81 @@
+#pragma once
+
+#include "LinkBackend.h"
+#include "Clock.h"
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * Replays a scripted or recorded trace of link state, RTT and loss against a virtual clock.
+ *
+ * Trace format, one event per line, `#` starts a comment:
+ *
+ *     <time_ms> <ifname> <up|down> [rtt_ms] [loss_percent]
+ *
+ * An event holds for its interface until the next event for the same interface.
+ * Omitted RTT and loss keep the interface's previous values.
+ */
+class SimulatedLinkBackend : public LinkBackend {
+public:
+
+    SimulatedLinkBackend() = delete;
+
+    /** 
+     * @brief Loads the trace at `tracePath` and binds it to `clock`.
+     * 
+     * @param tracePath Path to the trace file.
+     * @param clock Virtual clock the trace is replayed against.
+     * @param seed Seed for the loss generator, the same seed replays the same losses.
+     */
+    SimulatedLinkBackend(const std::string& tracePath, utils::Clock& clock, uint32_t seed);
+
+    /* methods */
+
+    bool isLinkUp(const std::string& ifname) override;
+
+    /** 
+     * @brief Simulates a single probe, taking the current RTT (or the probe timeout) of virtual time.
+     */
+    ProbeResult probe(const std::string& ifname, const std::string& ip) override;
+
+    std::string resolveAddress(const std::string& ifname) override;
+
+    bool finished() override;
+
+private:
+
+    struct LinkEvent {
+        std::chrono::milliseconds time;
+        bool up;
+        std::chrono::milliseconds rtt;
+        double loss;
+    };
+
+    /* methods */
+
+    /** 
+     * @brief Loads and validates the trace file.
+     * 
+     * @param tracePath Path to the trace file.
+     */
+    void loadTrace(const std::string& tracePath);
+
+    /** 
+     * @brief Returns the event in effect for `ifname` at the current virtual time.
+     * 
+     * @return const LinkEvent* The active event, `nullptr` for unknown interfaces or before the first event.
+     */
+    const LinkEvent* currentEvent(const std::string& ifname) const;
+
+    /* members */
+    utils::Clock& clock;
+    std::map<std::string, std::vector<LinkEvent>> trace;
+    std::chrono::milliseconds traceEnd{0};
+    std::mutex rngMutex;
+    std::mt19937 rng;
+};
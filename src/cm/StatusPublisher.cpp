@@ -0,0 +1,126 @@
+#include "StatusPublisher.h"
+#include "CMLogger.h"
+
+/* std */
+#include <new>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+StatusPublisher::StatusPublisher(const std::string& name) : name{name} {
+    snapshot.activeInterface = -1;
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd == -1) {
+        utils::CMLogger::log(utils::ERROR, "Failed to open status page " + name + ": " + strerror(errno));
+        return;
+    }
+
+    if (ftruncate(fd, sizeof(utils::StatusPage)) == -1) {
+        utils::CMLogger::log(utils::ERROR, "Failed to size status page " + name + ": " + strerror(errno));
+        close(fd);
+        return;
+    }
+
+    void *addr = mmap(nullptr, sizeof(utils::StatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        utils::CMLogger::log(utils::ERROR, "Failed to map status page " + name + ": " + strerror(errno));
+        return;
+    }
+
+    /* Readers ignore the page until magic and version match, so they are written last. */
+    page = static_cast<utils::StatusPage*>(addr);
+    page->magic = 0;
+    page->version = utils::STATUS_PAGE_VERSION;
+    page->size = sizeof(utils::StatusPage);
+    new (&page->sequence) std::atomic<uint32_t>(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    page->magic = utils::STATUS_PAGE_MAGIC;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    publish();
+    utils::CMLogger::log(utils::INFO, "Publishing status page " + name);
+}
+
+StatusPublisher::~StatusPublisher() {
+    if (page) {
+        /* Attached readers would keep polling the unlinked page, so mark it closed for good. */
+        std::lock_guard<std::mutex> lock(mutex);
+        page->magic = 0;
+        page->sequence.fetch_or(1, std::memory_order_release);
+
+        munmap(page, sizeof(utils::StatusPage));
+        shm_unlink(name.c_str());
+    }
+}
+
+void StatusPublisher::setInterface(int index, const std::string& ifname) {
+    if (index < 0 || index >= utils::STATUS_MAX_INTERFACES) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    utils::InterfaceStatus& status = snapshot.interfaces[index];
+    std::strncpy(status.ifname, ifname.c_str(), sizeof(status.ifname) - 1);
+    if (static_cast<uint32_t>(index) >= snapshot.interfaceCount) {
+        snapshot.interfaceCount = index + 1;
+    }
+    publish();
+}
+
+void StatusPublisher::setLinkUp(int index, bool up) {
+    if (index < 0 || index >= utils::STATUS_MAX_INTERFACES) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshot.interfaces[index].up = up;
+    publish();
+}
+
+void StatusPublisher::setProbeResult(int index, bool reachable, std::chrono::microseconds rtt) {
+    if (index < 0 || index >= utils::STATUS_MAX_INTERFACES) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    utils::InterfaceStatus& status = snapshot.interfaces[index];
+    status.reachable = reachable;
+    status.lastProbeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (reachable) {
+        status.lastRttUs = rtt.count();
+    }
+    if (index == snapshot.activeInterface) {
+        snapshot.deviceReachable = reachable;
+    }
+    publish();
+}
+
+void StatusPublisher::setActiveInterface(int index, uint32_t failoverCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (snapshot.activeInterface != index) {
+        snapshot.deviceReachable = (index >= 0 && index < utils::STATUS_MAX_INTERFACES) ? 
+            snapshot.interfaces[index].reachable : 0;
+    }
+    snapshot.activeInterface = index;
+    snapshot.failoverCount = failoverCount;
+    publish();
+}
+
+void StatusPublisher::setConnectionEstablished(bool established) {
+    std::lock_guard<std::mutex> lock(mutex);
+    snapshot.connectionEstablished = established;
+    publish();
+}
+
+void StatusPublisher::publish() {
+    if (!page) return;
+
+    snapshot.updatedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    uint32_t sequence = page->sequence.load(std::memory_order_relaxed);
+    page->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&page->snapshot, &snapshot, sizeof(snapshot));
+
+    page->sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "StatusPage.h"
+
+#include <mutex>
+#include <string>
+#include <chrono>
+
+/**
+ * Writer side of the shared-memory status page. Every setter updates a private copy of
+ * the snapshot and publishes it under the page's seqlock, so readers never see a torn update.
+ * If the page cannot be created CM keeps running and the setters do nothing.
+ */
+class StatusPublisher {
+public:
+
+    StatusPublisher() = delete;
+
+    /** 
+     * @brief Creates (or takes over) the shared-memory object `name` and publishes an empty snapshot.
+     * 
+     * @param name Name of the shared-memory object, as given to `shm_open`.
+     */
+    explicit StatusPublisher(const std::string& name);
+
+    ~StatusPublisher();
+
+    StatusPublisher(const StatusPublisher&) = delete;
+    StatusPublisher& operator=(const StatusPublisher&) = delete;
+
+    /* methods */
+
+    /** 
+     * @brief Registers the name of the interface at `index`.
+     */
+    void setInterface(int index, const std::string& ifname);
+
+    void setLinkUp(int index, bool up);
+
+    /** 
+     * @brief Records the outcome of a probe sent through the interface at `index`.
+     * 
+     * @param index The interface the probe went through.
+     * @param reachable Whether the device answered.
+     * @param rtt Round-trip time of the answered probe.
+     */
+    void setProbeResult(int index, bool reachable, std::chrono::microseconds rtt);
+
+    /** 
+     * @brief Records the interface CM currently uses.
+     * 
+     * @param index The active interface, -1 for none.
+     * @param failoverCount Number of switches between interfaces so far.
+     */
+    void setActiveInterface(int index, uint32_t failoverCount);
+
+    void setConnectionEstablished(bool established);
+
+private:
+
+    /* methods */
+
+    /** 
+     * @brief Copies the private snapshot into the page under the seqlock. Called with `mutex` held.
+     */
+    void publish();
+
+    /* members */
+    std::string name;
+    utils::StatusPage *page{nullptr};
+    std::mutex mutex;
+    utils::StatusSnapshot snapshot{};
+};
@@ -0,0 +1,59 @@
+#include "Clock.h"
+
+#include <thread>
+#include <stdexcept>
+
+namespace utils {
+    Clock::Clock(bool simulated, double speed) 
+        : simulated{simulated}, speed{speed}, start{std::chrono::steady_clock::now()} 
+    {
+        if (speed < 0) {
+            throw std::runtime_error("Clock speed must not be negative: " + std::to_string(speed));
+        }
+    }
+
+    std::chrono::milliseconds Clock::now() const {
+        if (simulated) {
+            return std::chrono::milliseconds(virtualNow.load());
+        }
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    void Clock::sleepFor(std::chrono::milliseconds duration) {
+        if (!simulated) {
+            std::this_thread::sleep_for(duration);
+            return;
+        }
+
+        std::function<void(std::chrono::milliseconds)> drive;
+        {
+            std::lock_guard<std::mutex> lock(driverMutex);
+            drive = driver;
+        }
+
+        if (drive) {
+            drive(now() + duration);
+        }
+        else {
+            advanceTo(now() + duration);
+        }
+    }
+
+    void Clock::advanceTo(std::chrono::milliseconds time) {
+        long long step = time.count() - virtualNow.load();
+        if (!simulated || step <= 0) {
+            return;
+        }
+
+        if (speed > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(step * 1000 / speed)));
+        }
+        virtualNow.store(time.count());
+    }
+
+    void Clock::setDriver(std::function<void(std::chrono::milliseconds time)> driver) {
+        std::lock_guard<std::mutex> lock(driverMutex);
+        this->driver = std::move(driver);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace utils {
+    class Clock {
+    public:
+
+        /* methods */
+
+        /** 
+         * @brief Creates a monotonic clock, or a virtual one for the link simulator.
+         * 
+         * A virtual clock starts at 0 and only moves when a thread sleeps on it, so a replayed
+         * trace takes the same steps in the same order on every run, however busy the host is.
+         * 
+         * @param simulated `true` for a virtual clock.
+         * @param speed Virtual milliseconds per real millisecond a virtual clock is paced to,
+         *              0 lets it run as fast as possible. Ignored by a monotonic clock.
+         */
+        explicit Clock(bool simulated = false, double speed = 0.0);
+
+        /** 
+         * @brief Returns the time elapsed since the clock was created.
+         * 
+         * @return std::chrono::milliseconds Milliseconds since construction, virtual when simulated.
+         */
+        std::chrono::milliseconds now() const;
+
+        /** 
+         * @brief Blocks the calling thread for the given amount of time.
+         * 
+         * On a virtual clock this advances the clock instead, through the driver if one is set.
+         * 
+         * @param duration Duration to sleep for.
+         */
+        void sleepFor(std::chrono::milliseconds duration);
+
+        /** 
+         * @brief Moves a virtual clock forward to `time`, pacing the step to the clock's speed.
+         * 
+         * @param time The new virtual time, earlier times are ignored.
+         */
+        void advanceTo(std::chrono::milliseconds time);
+
+        /** 
+         * @brief Hands virtual sleeps to `driver`, which must advance the clock to the given time.
+         * 
+         * Lets the timer service run the timers falling due while a thread sleeps on the clock.
+         * 
+         * @param driver The function advancing the clock, empty to advance it directly.
+         */
+        void setDriver(std::function<void(std::chrono::milliseconds time)> driver);
+
+        bool isSimulated() const { return simulated; }
+
+        double getSpeed() const { return speed; }
+
+    private:
+
+        /* members */
+        bool simulated;
+        double speed;
+        std::chrono::steady_clock::time_point start;
+        std::atomic<long long> virtualNow{0};
+        std::mutex driverMutex;
+        std::function<void(std::chrono::milliseconds time)> driver;
+    };
+}
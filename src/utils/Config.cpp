@@ -1,4 +1,5 @@
 #include "Config.h"
+#include "StatusPage.h"
 
 #include <string>
 #include <unistd.h>
@@ -70,6 +71,26 @@ namespace utils {
         config.ifname0 = map["ifname0"];
         config.ifname1 = map["ifname1"];
         config.isUsingSSH = (map["SSH"] == "1");
+        config.sshOptions.useMptcp = (map["mptcp"] == "1");
+        config.sshOptions.keepaliveInterval = map["keepalive"].empty() ? 5 : std::stoi(map["keepalive"]);
+        config.sshOptions.sessionDeadline = std::chrono::milliseconds(
+            map["sessionDeadline"].empty() ? 15000 : std::stol(map["sessionDeadline"]));
+        config.holdDownMs = map["holdDown"].empty() ? 30000 : std::stol(map["holdDown"]);
+        if (std::chrono::seconds(config.sshOptions.keepaliveInterval) >= config.sshOptions.sessionDeadline) {
+            throw std::runtime_error("keepalive (" + std::to_string(config.sshOptions.keepaliveInterval) + 
+                " s) must be shorter than sessionDeadline (" + 
+                std::to_string(config.sshOptions.sessionDeadline.count()) + " ms)");
+        }
+
+        config.useRouting = (map["routing"] == "1");
+        config.routeTable = map["routeTable"].empty() ? 200 : std::stoul(map["routeTable"]);
+        config.gateway0 = map["gw0"];
+        config.gateway1 = map["gw1"];
+        config.warmIntervalMs = map["warmInterval"].empty() ? 0 : std::stol(map["warmInterval"]);
+
+        config.monitorIntervalMs = map["monitorInterval"].empty() ? 5000 : std::stol(map["monitorInterval"]);
+        config.probeIntervalMs = map["probeInterval"].empty() ? 5000 : std::stol(map["probeInterval"]);
+        config.retryIntervalMs = map["retryInterval"].empty() ? 5000 : std::stol(map["retryInterval"]);
 
         if (config.isUsingSSH) {
             config.credentials.user = map["user"];
@@ -78,6 +99,12 @@ namespace utils {
             config.credentials.port = std::stoi(map["port"]);
         }
 
+        config.statusPage = map["statusPage"].empty() ? STATUS_PAGE_NAME : map["statusPage"];
+
+        config.simTracePath = map["sim"];
+        config.simSpeed = map["simSpeed"].empty() ? 0.0 : std::stod(map["simSpeed"]);
+        config.simSeed = map["simSeed"].empty() ? 1 : std::stoul(map["simSeed"]);
+
         return config;
     }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <chrono>
+#include <cstdint>
 
 struct CredentialsSSH {
     std::string user;
@@ -9,6 +11,12 @@ struct CredentialsSSH {
     int port;
 };
 
+struct SSHOptions {
+    bool useMptcp{false};
+    int keepaliveInterval{5};                               /* seconds between keepalives */
+    std::chrono::milliseconds sessionDeadline{15000};       /* silence after which a session is dead */
+};
+
 namespace utils {
     constexpr const char* DEFAULT_CONFIG_PATH = "settings.conf";
 
@@ -49,8 +57,32 @@ namespace utils {
         std::string ifname0;
         std::string ifname1;
 
+        /* Cadences, in milliseconds */
+        long monitorIntervalMs;
+        long probeIntervalMs;
+        long retryIntervalMs;
+
         /* SSH */
         bool isUsingSSH;
         CredentialsSSH credentials;
+        SSHOptions sshOptions;
+        long holdDownMs;
+
+        /* Policy routing */
+        bool useRouting;
+        uint32_t routeTable;
+        std::string gateway0;
+        std::string gateway1;
+
+        /* Standby path warming, 0 disables */
+        long warmIntervalMs;
+
+        /* Shared-memory status page */
+        std::string statusPage;
+
+        /* Link simulator */
+        std::string simTracePath;
+        double simSpeed;
+        uint32_t simSeed;
     };
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "Netlink.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/genetlink.h>
+
+namespace utils {
+    constexpr size_t RECEIVE_BUFFER_SIZE = 32768;
+
+    NetlinkMessage::NetlinkMessage(uint16_t type, uint16_t flags, const void* familyHeader, size_t size)
+        : buffer(NLMSG_SPACE(size), 0)
+    {
+        nlmsghdr *hdr = header();
+        hdr->nlmsg_len = NLMSG_LENGTH(size);
+        hdr->nlmsg_type = type;
+        hdr->nlmsg_flags = flags | NLM_F_REQUEST;
+        std::memcpy(NLMSG_DATA(hdr), familyHeader, size);
+    }
+
+    void NetlinkMessage::addAttr(uint16_t type, const void* data, size_t size) {
+        size_t offset = NLMSG_ALIGN(buffer.size());
+        buffer.resize(offset + NLA_ALIGN(NLA_HDRLEN + size), 0);
+
+        nlattr *attr = reinterpret_cast<nlattr*>(buffer.data() + offset);
+        attr->nla_type = type;
+        attr->nla_len = NLA_HDRLEN + size;
+        if (size) {
+            std::memcpy(buffer.data() + offset + NLA_HDRLEN, data, size);
+        }
+
+        header()->nlmsg_len = buffer.size();
+    }
+
+    size_t NetlinkMessage::beginNested(uint16_t type) {
+        size_t offset = buffer.size();
+        addAttr(type | NLA_F_NESTED, nullptr, 0);
+        return offset;
+    }
+
+    void NetlinkMessage::endNested(size_t offset) {
+        reinterpret_cast<nlattr*>(buffer.data() + offset)->nla_len = buffer.size() - offset;
+    }
+
+    NetlinkSocket::NetlinkSocket(int protocol, uint32_t groups) {
+        fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, protocol);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to open netlink socket: " + std::string(strerror(errno)));
+        }
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = groups;
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+            int err = errno;
+            close(fd);
+            throw std::runtime_error("Failed to bind netlink socket: " + std::string(strerror(err)));
+        }
+    }
+
+    NetlinkSocket::~NetlinkSocket() {
+        close(fd);
+    }
+
+    int NetlinkSocket::request(NetlinkMessage& message, std::vector<char>* reply) {
+        message.header()->nlmsg_flags |= NLM_F_ACK;
+        int res = send(message);
+        if (res < 0) {
+            return res;
+        }
+
+        std::vector<char> buffer(RECEIVE_BUFFER_SIZE);
+        while (true) {
+            ssize_t len = recv(fd, buffer.data(), buffer.size(), 0);
+            if (len == -1) {
+                if (errno == EINTR) continue;
+                return -errno;
+            }
+
+            for (nlmsghdr *answer = reinterpret_cast<nlmsghdr*>(buffer.data()); NLMSG_OK(answer, len); 
+                 answer = NLMSG_NEXT(answer, len)) {
+                if (answer->nlmsg_seq != sequence) {
+                    continue;
+                }
+                if (answer->nlmsg_type == NLMSG_ERROR) {
+                    return static_cast<nlmsgerr*>(NLMSG_DATA(answer))->error;
+                }
+                if (answer->nlmsg_type == NLMSG_DONE) {
+                    return 0;
+                }
+                if (reply && reply->empty()) {
+                    char *data = reinterpret_cast<char*>(answer);
+                    reply->assign(data, data + answer->nlmsg_len);
+                }
+            }
+        }
+    }
+
+    int NetlinkSocket::resolveFamily(const std::string& name) {
+        genlmsghdr genl{};
+        genl.cmd = CTRL_CMD_GETFAMILY;
+        genl.version = 1;
+
+        NetlinkMessage message(GENL_ID_CTRL, 0, &genl, sizeof(genl));
+        message.addAttrString(CTRL_ATTR_FAMILY_NAME, name);
+
+        int res = send(message);
+        if (res < 0) {
+            return res;
+        }
+
+        std::vector<char> buffer(RECEIVE_BUFFER_SIZE);
+        ssize_t len;
+        do {
+            len = recv(fd, buffer.data(), buffer.size(), 0);
+        } while (len == -1 && errno == EINTR);
+        if (len == -1) {
+            return -errno;
+        }
+
+        for (nlmsghdr *reply = reinterpret_cast<nlmsghdr*>(buffer.data()); NLMSG_OK(reply, len); 
+             reply = NLMSG_NEXT(reply, len)) {
+            if (reply->nlmsg_type == NLMSG_ERROR) {
+                return static_cast<nlmsgerr*>(NLMSG_DATA(reply))->error;
+            }
+            if (reply->nlmsg_type != GENL_ID_CTRL) {
+                continue;
+            }
+
+            int attrLen = reply->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+            nlattr *attr = reinterpret_cast<nlattr*>(static_cast<char*>(NLMSG_DATA(reply)) + GENL_HDRLEN);
+            while (attrLen >= NLA_HDRLEN && attr->nla_len >= NLA_HDRLEN && attr->nla_len <= attrLen) {
+                if ((attr->nla_type & NLA_TYPE_MASK) == CTRL_ATTR_FAMILY_ID) {
+                    uint16_t id;
+                    std::memcpy(&id, reinterpret_cast<char*>(attr) + NLA_HDRLEN, sizeof(id));
+                    return id;
+                }
+                attrLen -= NLA_ALIGN(attr->nla_len);
+                attr = reinterpret_cast<nlattr*>(reinterpret_cast<char*>(attr) + NLA_ALIGN(attr->nla_len));
+            }
+        }
+
+        return -ENOENT;
+    }
+
+    int NetlinkSocket::send(NetlinkMessage& message) {
+        message.header()->nlmsg_seq = ++sequence;
+
+        sockaddr_nl kernel{};
+        kernel.nl_family = AF_NETLINK;
+        if (sendto(fd, message.header(), message.size(), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) == -1) {
+            return -errno;
+        }
+
+        return 0;
+    }
+
+    ssize_t NetlinkSocket::receive(std::vector<char>& buffer) {
+        buffer.resize(RECEIVE_BUFFER_SIZE);
+        ssize_t len = recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (len == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return -errno;
+        }
+
+        buffer.resize(len);
+        return len;
+    }
+}
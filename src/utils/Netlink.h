@@ -0,0 +1,124 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <linux/netlink.h>
+
+namespace utils {
+    /**
+     * A netlink request under construction: the `nlmsghdr`, the family header and attributes,
+     * laid out with the alignment the kernel expects.
+     */
+    class NetlinkMessage {
+    public:
+
+        NetlinkMessage() = delete;
+
+        /** 
+         * @brief Starts a message of `type` with the family header `familyHeader` of `size` bytes.
+         * 
+         * @param type Message type, e.g. `RTM_NEWROUTE` or a generic netlink family id.
+         * @param flags `NLM_F_*` flags, `NLM_F_REQUEST` is always added.
+         * @param familyHeader Fixed header following `nlmsghdr` (`rtmsg`, `genlmsghdr`, ...).
+         * @param size Size of `familyHeader`.
+         */
+        NetlinkMessage(uint16_t type, uint16_t flags, const void* familyHeader, size_t size);
+
+        /* methods */
+
+        void addAttr(uint16_t type, const void* data, size_t size);
+        void addAttrU8(uint16_t type, uint8_t value) { addAttr(type, &value, sizeof(value)); }
+        void addAttrU16(uint16_t type, uint16_t value) { addAttr(type, &value, sizeof(value)); }
+        void addAttrU32(uint16_t type, uint32_t value) { addAttr(type, &value, sizeof(value)); }
+        void addAttrString(uint16_t type, const std::string& value) { addAttr(type, value.c_str(), value.size() + 1); }
+
+        /** 
+         * @brief Opens a nested attribute, every attribute added until `endNested` goes inside it.
+         * 
+         * @return size_t Offset to pass to `endNested`.
+         */
+        size_t beginNested(uint16_t type);
+
+        void endNested(size_t offset);
+
+        nlmsghdr* header() { return reinterpret_cast<nlmsghdr*>(buffer.data()); }
+        size_t size() const { return buffer.size(); }
+
+    private:
+
+        /* members */
+        std::vector<char> buffer;
+    };
+
+    /**
+     * A netlink socket of one protocol (`NETLINK_ROUTE`, `NETLINK_GENERIC`, ...).
+     * Requests report failures as negative errno values, like the kernel does.
+     */
+    class NetlinkSocket {
+    public:
+
+        NetlinkSocket() = delete;
+
+        /** 
+         * @brief Opens and binds a netlink socket.
+         * 
+         * @param protocol Netlink protocol.
+         * @param groups Multicast groups to listen to, 0 for a request-only socket.
+         */
+        explicit NetlinkSocket(int protocol, uint32_t groups = 0);
+
+        ~NetlinkSocket();
+
+        NetlinkSocket(const NetlinkSocket&) = delete;
+        NetlinkSocket& operator=(const NetlinkSocket&) = delete;
+
+        /* methods */
+
+        /** 
+         * @brief Sends `message` with `NLM_F_ACK` and waits for the kernel's answer.
+         * 
+         * @param message The request.
+         * @param reply Receives the first reply message (`nlmsghdr` included) for `get` requests,
+         *              may be `nullptr`.
+         * 
+         * @return int 0 on success, negative errno on failure.
+         */
+        int request(NetlinkMessage& message, std::vector<char>* reply = nullptr);
+
+        /** 
+         * @brief Looks up the id of a generic netlink family.
+         * 
+         * @param name Family name, e.g. "mptcp_pm".
+         * 
+         * @return int The family id, negative errno if the family is not available.
+         */
+        int resolveFamily(const std::string& name);
+
+        /** 
+         * @brief Receives one datagram of notifications or replies without blocking.
+         * 
+         * @param buffer Receives the datagram, may hold several messages.
+         * 
+         * @return ssize_t Bytes received, 0 if nothing is pending, negative errno on failure.
+         */
+        ssize_t receive(std::vector<char>& buffer);
+
+        int getFd() const { return fd; }
+
+    private:
+
+        /* methods */
+
+        /** 
+         * @brief Stamps `message` with the next sequence number and sends it to the kernel.
+         * 
+         * @return int 0 on success, negative errno on failure.
+         */
+        int send(NetlinkMessage& message);
+
+        /* members */
+        int fd;
+        uint32_t sequence{0};
+    };
+}
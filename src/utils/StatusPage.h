@@ -0,0 +1,132 @@
+#pragma once
+
+/*
+ * Layout of the status page CM publishes in POSIX shared memory, plus a reader.
+ *
+ * This header only depends on the standard library and POSIX, so other processes can
+ * include it on its own. After `openStatusPage`, `readStatus` makes no syscalls and never
+ * blocks the writer: it retries while CM is in the middle of an update (seqlock).
+ *
+ * When CM exits it marks the page closed and unlinks it. A restarted CM publishes a new page
+ * under the same name, so once `statusPageClosed` is true readers must `closeStatusPage` and
+ * call `openStatusPage` again until it succeeds.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace utils {
+    constexpr const char* STATUS_PAGE_NAME = "/cm-status";
+    constexpr uint32_t STATUS_PAGE_MAGIC = 0x434d5350;  /* "CMSP" */
+    constexpr uint32_t STATUS_PAGE_VERSION = 1;
+    constexpr int STATUS_MAX_INTERFACES = 4;
+
+    struct InterfaceStatus {
+        char ifname[16];
+        uint8_t up;
+        uint8_t reachable;          /* last probe through this interface was answered */
+        uint8_t reserved[2];
+        uint32_t lastRttUs;         /* RTT of the last answered probe, 0 if none yet */
+        uint64_t lastProbeMs;       /* CLOCK_MONOTONIC time of the last probe, 0 if none yet */
+    };
+
+    struct StatusSnapshot {
+        uint32_t interfaceCount;
+        int32_t activeInterface;    /* index into `interfaces`, -1 when none is selected */
+        uint8_t connectionEstablished;
+        uint8_t deviceReachable;
+        uint8_t reserved[2];
+        uint32_t failoverCount;
+        uint64_t updatedMs;         /* CLOCK_MONOTONIC time of the last update */
+        InterfaceStatus interfaces[STATUS_MAX_INTERFACES];
+    };
+
+    struct StatusPage {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t size;
+        std::atomic<uint32_t> sequence;   /* odd while the writer is updating `snapshot`, or once closed */
+        StatusSnapshot snapshot;
+    };
+
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "status page needs a lock-free sequence counter");
+
+    /** 
+     * @brief Maps the status page read-only.
+     * 
+     * @param name Name of the shared-memory object, as given to `shm_open`.
+     * 
+     * @return const StatusPage* The mapped page, `nullptr` if it does not exist or has a different version.
+     */
+    inline const StatusPage* openStatusPage(const char* name = STATUS_PAGE_NAME) {
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd == -1) {
+            return nullptr;
+        }
+
+        void *addr = mmap(nullptr, sizeof(StatusPage), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return nullptr;
+        }
+
+        const StatusPage *page = static_cast<const StatusPage*>(addr);
+        if (page->magic != STATUS_PAGE_MAGIC || page->version != STATUS_PAGE_VERSION || 
+            page->size != sizeof(StatusPage)) {
+            munmap(addr, sizeof(StatusPage));
+            return nullptr;
+        }
+
+        return page;
+    }
+
+    /** 
+     * @brief Unmaps a page returned by `openStatusPage`.
+     */
+    inline void closeStatusPage(const StatusPage* page) {
+        munmap(const_cast<StatusPage*>(page), sizeof(StatusPage));
+    }
+
+    /** 
+     * @brief Tells whether CM has closed the page, which then never changes again.
+     */
+    inline bool statusPageClosed(const StatusPage* page) {
+        page->sequence.load(std::memory_order_acquire);
+        return page->magic != STATUS_PAGE_MAGIC;
+    }
+
+    /** 
+     * @brief Copies a consistent snapshot out of the page.
+     * 
+     * @param page The mapped page.
+     * @param out Receives the snapshot.
+     * @param attempts How many times to retry while the writer is busy.
+     * 
+     * @return bool `true` if `out` holds a consistent snapshot, `false` if every attempt raced the
+     *              writer or the page is closed.
+     */
+    inline bool readStatus(const StatusPage* page, StatusSnapshot& out, int attempts = 64) {
+        for (int i = 0; i < attempts; ++i) {
+            uint32_t begin = page->sequence.load(std::memory_order_acquire);
+            if (page->magic != STATUS_PAGE_MAGIC) {
+                return false;
+            }
+            if (begin & 1) {
+                continue;
+            }
+
+            std::memcpy(&out, &page->snapshot, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (page->sequence.load(std::memory_order_relaxed) == begin) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
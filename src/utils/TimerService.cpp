@@ -0,0 +1,365 @@
+#include "TimerService.h"
+#include "CMLogger.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+namespace utils {
+    constexpr long TICK_NS = 1000000;
+    constexpr int MAX_EVENTS = 16;
+
+    void Wakeup::notify() {
+        std::lock_guard<std::mutex> lock(mutex);
+        notified = true;
+        cv.notify_all();
+    }
+
+    TimerService::TimerService(Clock& clock) : clock{clock} {
+        timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (timerfd == -1) {
+            throw std::runtime_error("Failed to create timerfd: " + std::string(strerror(errno)));
+        }
+
+        epollfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollfd == -1) {
+            close(timerfd);
+            throw std::runtime_error("Failed to create epoll instance: " + std::string(strerror(errno)));
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = timerfd;
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, timerfd, &event);
+
+        if (clock.isSimulated()) {
+            clock.setDriver([this](std::chrono::milliseconds time) { runUntil(time.count(), nullptr); });
+        }
+    }
+
+    TimerService::~TimerService() {
+        if (clock.isSimulated()) {
+            clock.setDriver(nullptr);
+        }
+        stop();
+        close(epollfd);
+        close(timerfd);
+    }
+
+    void TimerService::start() {
+        running.store(true);
+        thread = std::thread(&TimerService::serviceLoop, this);
+    }
+
+    void TimerService::stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+
+        fireNow();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    TimerId TimerService::schedule(std::chrono::milliseconds delay, std::function<void()> callback) {
+        return add(delay.count() > 0 ? delay.count() : 0, 0, std::move(callback));
+    }
+
+    TimerId TimerService::schedulePeriodic(std::chrono::milliseconds period, std::function<void()> callback) {
+        if (period.count() <= 0) {
+            throw std::runtime_error("Timer period must be positive: " + std::to_string(period.count()));
+        }
+
+        return add(period.count(), period.count(), std::move(callback));
+    }
+
+    bool TimerService::cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto found = timers.find(id);
+        if (found == timers.end()) {
+            return false;
+        }
+
+        found->second.slot->erase(found->second.it);
+        timers.erase(found);
+        rearm();
+
+        return true;
+    }
+
+    bool TimerService::watch(int fd, std::function<void()> onReadable) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            CMLogger::log(ERROR, "Failed to watch fd " + std::to_string(fd) + ": " + strerror(errno));
+            return false;
+        }
+
+        watches[fd] = std::move(onReadable);
+        return true;
+    }
+
+    void TimerService::unwatch(int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        epoll_ctl(epollfd, EPOLL_CTL_DEL, fd, nullptr);
+        watches.erase(fd);
+    }
+
+    bool TimerService::sleepFor(std::chrono::milliseconds duration, Wakeup& wakeup) {
+        uint64_t token;
+        {
+            std::lock_guard<std::mutex> lock(wakeup.mutex);
+            token = ++wakeup.sleeps;
+        }
+
+        if (clock.isSimulated()) {
+            runUntil(clock.now().count() + duration.count(), &wakeup);
+
+            std::lock_guard<std::mutex> lock(wakeup.mutex);
+            bool elapsed = !wakeup.notified;
+            wakeup.notified = false;
+            return elapsed;
+        }
+
+        TimerId id = schedule(duration, [&wakeup, token] {
+            std::lock_guard<std::mutex> lock(wakeup.mutex);
+            wakeup.expired = token;
+            wakeup.cv.notify_all();
+        });
+
+        bool elapsed;
+        {
+            std::unique_lock<std::mutex> lock(wakeup.mutex);
+            wakeup.cv.wait(lock, [&wakeup, token] { return wakeup.notified || wakeup.expired == token; });
+            elapsed = !wakeup.notified;
+            wakeup.notified = false;
+        }
+
+        cancel(id);
+        return elapsed;
+    }
+
+    TimerId TimerService::add(uint64_t delay, uint64_t period, std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        uint64_t now = ticksNow();
+        if (timers.empty()) {
+            current = now;
+        }
+
+        TimerId id = nextId++;
+        Slot pending;
+        pending.push_back(Timer{id, now + delay, period, std::move(callback)});
+        place(pending, pending.begin());
+        rearm();
+
+        return id;
+    }
+
+    void TimerService::place(Slot& from, Slot::iterator it) {
+        uint64_t expires = it->expires < current ? current : it->expires;
+        if (expires - current > MAX_SPAN) {
+            expires = current + MAX_SPAN;
+        }
+
+        int level = 0;
+        while (level < LEVELS - 1 && expires - current >= (1ULL << (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+
+        Slot& slot = wheel[level][(expires >> (SLOT_BITS * level)) & (SLOTS - 1)];
+        slot.splice(slot.end(), from, it);
+        timers[it->id] = Location{&slot, it};
+    }
+
+    void TimerService::cascade(int level) {
+        Slot pending;
+        pending.splice(pending.end(), wheel[level][(current >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+
+        while (!pending.empty()) {
+            place(pending, pending.begin());
+        }
+    }
+
+    void TimerService::advance(uint64_t target, std::vector<std::function<void()>>& due) {
+        while (current <= target) {
+            if (timers.empty()) {
+                current = target + 1;
+                break;
+            }
+
+            for (int level = 1; level < LEVELS; ++level) {
+                if ((current >> (SLOT_BITS * (level - 1))) & (SLOTS - 1)) {
+                    break;
+                }
+                cascade(level);
+            }
+
+            Slot fired;
+            fired.splice(fired.end(), wheel[0][current & (SLOTS - 1)]);
+            ++current;
+
+            while (!fired.empty()) {
+                Slot::iterator it = fired.begin();
+                if (it->period == 0) {
+                    due.push_back(std::move(it->callback));
+                    timers.erase(it->id);
+                    fired.erase(it);
+                    continue;
+                }
+
+                due.push_back(it->callback);
+                it->expires += it->period;
+                if (it->expires < current) {
+                    it->expires += (current - it->expires + it->period - 1) / it->period * it->period;
+                }
+                place(fired, it);
+            }
+        }
+    }
+
+    uint64_t TimerService::nextExpiry() const {
+        uint64_t next = UINT64_MAX;
+        for (int tick = 0; tick < SLOTS; ++tick) {
+            if (!wheel[0][(current + tick) & (SLOTS - 1)].empty()) {
+                next = current + tick;
+                break;
+            }
+        }
+
+        for (int level = 1; level < LEVELS; ++level) {
+            /* On a boundary of this level the slot at `current` itself has not cascaded yet. */
+            int shift = SLOT_BITS * level;
+            uint64_t first = (current >> shift) + ((current & ((1ULL << shift) - 1)) ? 1 : 0);
+            for (uint64_t position = first; position < first + SLOTS; ++position) {
+                if (!wheel[level][position & (SLOTS - 1)].empty()) {
+                    next = std::min(next, position << shift);
+                    break;
+                }
+            }
+        }
+
+        return next;
+    }
+
+    void TimerService::rearm() {
+        itimerspec spec{};
+        if (!timers.empty() && !clock.isSimulated()) {
+            uint64_t now = ticksNow();
+            uint64_t next = nextExpiry();
+            long long delayNs = next > now ? static_cast<long long>(next - now) * TICK_NS : 0;
+
+            spec.it_value.tv_sec = delayNs / 1000000000;
+            spec.it_value.tv_nsec = std::max(delayNs % 1000000000, 1LL);
+        }
+
+        if (timerfd_settime(timerfd, 0, &spec, nullptr) == -1) {
+            CMLogger::log(ERROR, "Failed to arm timerfd: " + std::string(strerror(errno)));
+        }
+    }
+
+    void TimerService::fireNow() {
+        itimerspec spec{};
+        spec.it_value.tv_nsec = 1;
+
+        if (timerfd_settime(timerfd, 0, &spec, nullptr) == -1) {
+            CMLogger::log(ERROR, "Failed to arm timerfd: " + std::string(strerror(errno)));
+        }
+    }
+
+    void TimerService::serviceLoop() {
+        while (running.load()) {
+            epoll_event events[MAX_EVENTS];
+            int count = epoll_wait(epollfd, events, MAX_EVENTS, -1);
+            if (count == -1) {
+                if (errno == EINTR) continue;
+                CMLogger::log(ERROR, "Failed to wait for timer events: " + std::string(strerror(errno)));
+                break;
+            }
+
+            std::vector<std::function<void()>> due;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (int i = 0; i < count; ++i) {
+                    if (events[i].data.fd == timerfd) {
+                        uint64_t expirations;
+                        if (read(timerfd, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN) {
+                            CMLogger::log(ERROR, "Failed to read timerfd: " + std::string(strerror(errno)));
+                        }
+                        continue;
+                    }
+
+                    auto found = watches.find(events[i].data.fd);
+                    if (found != watches.end()) {
+                        due.push_back(found->second);
+                    }
+                }
+
+                if (!clock.isSimulated()) {
+                    advance(ticksNow(), due);
+                    rearm();
+                }
+            }
+
+            for (auto& callback : due) {
+                if (!running.load()) {
+                    break;
+                }
+
+                try {
+                    callback();
+                }
+                catch (const std::runtime_error& e) {
+                    CMLogger::log(ERROR, "Timer callback failed: " + std::string(e.what()));
+                }
+            }
+        }
+    }
+
+    void TimerService::runUntil(uint64_t target, Wakeup *wakeup) {
+        auto woken = [wakeup] {
+            if (!wakeup) return false;
+            std::lock_guard<std::mutex> lock(wakeup->mutex);
+            return wakeup->notified;
+        };
+
+        while (!woken() && ticksNow() < target) {
+            uint64_t next;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                next = timers.empty() ? target : std::min(nextExpiry(), target);
+            }
+
+            clock.advanceTo(std::chrono::milliseconds(next));
+
+            std::vector<std::function<void()>> due;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                advance(ticksNow(), due);
+            }
+
+            for (auto& callback : due) {
+                try {
+                    callback();
+                }
+                catch (const std::runtime_error& e) {
+                    CMLogger::log(ERROR, "Timer callback failed: " + std::string(e.what()));
+                }
+            }
+        }
+    }
+
+    uint64_t TimerService::ticksNow() const {
+        return clock.now().count();
+    }
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <list>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+namespace utils {
+    using TimerId = uint64_t;
+
+    /**
+     * Lets a thread sleeping in `TimerService::sleepFor` be woken before its timer expires.
+     * A notification sent while nobody sleeps is kept and ends the next sleep immediately.
+     */
+    class Wakeup {
+    public:
+
+        /* methods */
+
+        /** 
+         * @brief Wakes the thread sleeping on this object, or the next one to sleep on it.
+         */
+        void notify();
+
+    private:
+        friend class TimerService;
+
+        /* members */
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool notified{false};
+        uint64_t sleeps{0};
+        uint64_t expired{0};
+    };
+
+    /**
+     * Central timer service: a hierarchical timing wheel with millisecond ticks, driven by
+     * a single one-shot `timerfd` and one service thread that only wakes for due timers. Insert and cancel are O(1); callbacks run
+     * on the service thread and must not block. The same thread can also watch other file
+     * descriptors, such as netlink sockets, through `watch`.
+     *
+     * On a virtual clock the `timerfd` stays disarmed: timers run on the thread sleeping on the
+     * clock, at exactly their virtual deadline, while the service thread only serves watches.
+     */
+    class TimerService {
+    public:
+
+        TimerService() = delete;
+
+        /** 
+         * @brief Creates a stopped service whose ticks follow `clock`.
+         * 
+         * @param clock Clock the timeouts are measured in, virtual when simulating.
+         */
+        explicit TimerService(Clock& clock);
+
+        ~TimerService();
+
+        TimerService(const TimerService&) = delete;
+        TimerService& operator=(const TimerService&) = delete;
+
+        /* methods */
+
+        /** 
+         * @brief Starts the service thread.
+         */
+        void start();
+
+        /** 
+         * @brief Stops the service thread, pending timers are dropped without running.
+         */
+        void stop();
+
+        /** 
+         * @brief Runs `callback` once after `delay`.
+         * 
+         * @param delay Time from now until the callback runs.
+         * @param callback Function run on the service thread.
+         * 
+         * @return TimerId Handle for `cancel`.
+         */
+        TimerId schedule(std::chrono::milliseconds delay, std::function<void()> callback);
+
+        /** 
+         * @brief Runs `callback` every `period`, starting one period from now.
+         * 
+         * Expiries are computed from the previous deadline, so the cadence does not drift.
+         * 
+         * @param period Interval between runs, at least one millisecond.
+         * @param callback Function run on the service thread.
+         * 
+         * @return TimerId Handle for `cancel`.
+         */
+        TimerId schedulePeriodic(std::chrono::milliseconds period, std::function<void()> callback);
+
+        /** 
+         * @brief Cancels a pending timer.
+         * 
+         * @param id Handle returned by `schedule` or `schedulePeriodic`.
+         * 
+         * @return bool `true` if the timer was pending, `false` if it already ran or never existed.
+         */
+        bool cancel(TimerId id);
+
+        /** 
+         * @brief Runs `onReadable` on the service thread whenever `fd` becomes readable.
+         * 
+         * The callback must drain `fd`, the watch is level-triggered.
+         * 
+         * @param fd The file descriptor to watch.
+         * @param onReadable Function run on the service thread.
+         * 
+         * @return bool `true` if the descriptor is now watched.
+         */
+        bool watch(int fd, std::function<void()> onReadable);
+
+        /** 
+         * @brief Stops watching `fd`. Must be called before `fd` is closed.
+         */
+        void unwatch(int fd);
+
+        /** 
+         * @brief Blocks the calling thread for `duration` or until `wakeup` is notified.
+         * 
+         * @param duration Time to sleep for.
+         * @param wakeup Object other threads notify to end the sleep early.
+         * 
+         * @return bool `true` if the full duration elapsed, `false` if woken early.
+         */
+        bool sleepFor(std::chrono::milliseconds duration, Wakeup& wakeup);
+
+    private:
+
+        static constexpr int SLOT_BITS = 6;
+        static constexpr int SLOTS = 1 << SLOT_BITS;
+        static constexpr int LEVELS = 4;
+        static constexpr uint64_t MAX_SPAN = (1ULL << (SLOT_BITS * LEVELS)) - 1;
+
+        struct Timer {
+            TimerId id;
+            uint64_t expires;
+            uint64_t period;
+            std::function<void()> callback;
+        };
+
+        using Slot = std::list<Timer>;
+
+        struct Location {
+            Slot *slot;
+            Slot::iterator it;
+        };
+
+        /* methods */
+
+        /** 
+         * @brief Adds a timer to the wheel and re-arms the `timerfd` for the new next expiry.
+         */
+        TimerId add(uint64_t delay, uint64_t period, std::function<void()> callback);
+
+        /** 
+         * @brief Moves the timer at `it` out of `from` into the wheel slot matching its expiry.
+         */
+        void place(Slot& from, Slot::iterator it);
+
+        /** 
+         * @brief Re-places every timer of a higher-level slot into the levels below it.
+         */
+        void cascade(int level);
+
+        /** 
+         * @brief Advances the wheel through tick `target`, collecting the callbacks that became due.
+         */
+        void advance(uint64_t target, std::vector<std::function<void()>>& due);
+
+        /** 
+         * @brief Returns the tick of the next expiry or cascade in the wheel, which must not be empty.
+         * 
+         * Timers on higher levels only report the tick their slot cascades at, so the service
+         * may wake once early for them and then re-arm for the exact expiry.
+         */
+        uint64_t nextExpiry() const;
+
+        /** 
+         * @brief Arms the `timerfd` once for `nextExpiry`, or disarms it when no timer is pending.
+         */
+        void rearm();
+
+        /** 
+         * @brief Makes the `timerfd` fire as soon as possible, used to wake the service thread.
+         */
+        void fireNow();
+
+        /** 
+         * @brief Advances a virtual clock to `target`, running every timer due on the way.
+         * 
+         * @param target The virtual tick to stop at.
+         * @param wakeup Ends the run at the current time once notified, may be `nullptr`.
+         */
+        void runUntil(uint64_t target, Wakeup *wakeup);
+
+        void serviceLoop();
+
+        uint64_t ticksNow() const;
+
+        /* members */
+        Clock& clock;
+        int timerfd;
+        int epollfd;
+        std::thread thread;
+        std::atomic<bool> running{false};
+
+        std::mutex mutex;
+        std::array<std::array<Slot, SLOTS>, LEVELS> wheel;
+        std::unordered_map<TimerId, Location> timers;
+        std::unordered_map<int, std::function<void()>> watches;
+        uint64_t current{0};
+        TimerId nextId{1};
+    };
+}
@@ -0,0 +1,98 @@
+#include "TimerService.h"
+#include "CMLogger.h"
+
+/* std */
+#include <random>
+#include <vector>
+#include <string>
+#include <iostream>
+
+using namespace std::chrono;
+
+static int failures = 0;
+
+static void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "FAIL: " << what << std::endl;
+    }
+}
+
+/* Every one-shot timer must fire exactly at its deadline on the virtual clock. */
+static void testOneShotDeadlines() {
+    utils::Clock clock{true};
+    utils::TimerService timers{clock};
+    utils::Wakeup wakeup;
+    std::mt19937 rng{1};
+    std::uniform_int_distribution<int> delays{0, 300000};
+
+    int late = 0;
+    int fired = 0;
+    for (int i = 0; i < 20000; ++i) {
+        milliseconds delay{delays(rng)};
+        milliseconds deadline = clock.now() + delay;
+        timers.schedule(delay, [&clock, &late, &fired, deadline] {
+            ++fired;
+            if (clock.now() != deadline) ++late;
+        });
+
+        if (i % 16 == 0) {
+            timers.sleepFor(milliseconds(delays(rng) % 100), wakeup);
+        }
+    }
+
+    timers.sleepFor(milliseconds(400000), wakeup);
+    expect(fired == 20000, "one-shot timers fired " + std::to_string(fired) + " of 20000");
+    expect(late == 0, std::to_string(late) + " one-shot timers missed their deadline");
+}
+
+/* A periodic timer must keep its exact cadence across every level of the wheel. */
+static void testPeriodicCadence() {
+    utils::Clock clock{true};
+    utils::TimerService timers{clock};
+    utils::Wakeup wakeup;
+
+    int runs = 0;
+    int off = 0;
+    timers.schedulePeriodic(milliseconds(777), [&clock, &runs, &off] {
+        ++runs;
+        if (clock.now() != milliseconds(777 * runs)) ++off;
+    });
+    timers.schedulePeriodic(milliseconds(5000), [] {});
+
+    timers.sleepFor(milliseconds(777 * 2000), wakeup);
+    expect(runs == 2000, "periodic timer ran " + std::to_string(runs) + " of 2000 times");
+    expect(off == 0, std::to_string(off) + " periodic runs were off their cadence");
+}
+
+/* On the real clock, a timer due right after a cascade boundary must not wait for the next rotation. */
+static void testRealCascadeBoundary() {
+    utils::Clock clock;
+    utils::TimerService timers{clock};
+    utils::Wakeup wakeup;
+    timers.start();
+
+    milliseconds firedAt{0};
+    milliseconds started = clock.now();
+    timers.schedule(milliseconds(63), [] {});
+    timers.schedule(milliseconds(99), [&clock, &firedAt] { firedAt = clock.now(); });
+
+    timers.sleepFor(milliseconds(300), wakeup);
+    milliseconds delay = firedAt - started;
+    expect(delay >= milliseconds(99) && delay < milliseconds(150), 
+        "99 ms timer fired after " + std::to_string(delay.count()) + " ms");
+    timers.stop();
+}
+
+int main() {
+    utils::CMLogger::setFilepath("/dev/null");
+
+    testOneShotDeadlines();
+    testPeriodicCadence();
+    for (int i = 0; i < 5; ++i) {
+        testRealCascadeBoundary();
+    }
+
+    std::cout << (failures ? "TimerService tests failed" : "TimerService tests passed") << std::endl;
+    return failures ? 1 : 0;
+}